@@ -17,14 +17,24 @@
 #endif
 
 // openpiv
+#include "algos/block_matching.h"
+#include "algos/direct_correlation.h"
+#include "algos/ensemble_correlation.h"
 #include "algos/fft.h"
 #include "algos/pocket_fft.h"
+#include "algos/sliding_dft.h"
+#include "algos/spectrum_cache.h"
+#include "algos/stats.h"
+#include "algos/window_stats.h"
 #include "loaders/image_loader.h"
+#include "core/adaptive_grid.h"
 #include "core/enumerate.h"
 #include "core/grid.h"
 #include "core/image.h"
+#include "core/image_band.h"
 #include "core/image_utils.h"
 #include "core/log.h"
+#include "core/parallel.h"
 #include "core/stream_utils.h"
 #include "core/vector.h"
 
@@ -45,7 +55,16 @@ int main( int argc, char* argv[] )
     std::string execution;
     uint8_t thread_count = std::thread::hardware_concurrency()-1;
     bool limit_search = false;
+    bool zncc = false;
+    bool ensemble = false;
+    bool pad = false;
+    uint32_t sliding_dft = 0;
+    uint32_t spectrum_cache_mb = 0;
+    uint32_t max_lag = 0;
     std::string fft_type;
+    uint8_t adaptive_levels = 0;
+    core::refinement_criteria refinement;
+    algos::signal_thresholds thresholds;
     auto log_level = logger::Level::INFO;
 
     try
@@ -60,6 +79,18 @@ int main( int argc, char* argv[] )
             ("e, exec", "execution method", cxxopts::value<std::string>(execution)->default_value("pool"))
             ("l, limit-search", "limit peak search to central 25% of interrogation area", cxxopts::value<bool>(limit_search))
             ("f, ffttype", "FFT type", cxxopts::value<std::string>(fft_type)->default_value("complex"))
+            ("max-lag", "largest displacement evaluated by the direct correlator & block matching; 0 derives it from the search area", cxxopts::value<uint32_t>(max_lag)->default_value("0"))
+            ("pad", "zero-pad windows to twice their size so the correlation doesn't wrap around", cxxopts::value<bool>(pad))
+            ("sliding-dft", "derive the spectrum of each interrogation area from its left neighbour, recomputing every N areas; 0 disables", cxxopts::value<uint32_t>(sliding_dft)->default_value("0"))
+            ("ensemble", "average correlations over consecutive pairs of input images", cxxopts::value<bool>(ensemble))
+            ("spectrum-cache", "size in MB of the cache of window spectra used by ensemble correlation", cxxopts::value<uint32_t>(spectrum_cache_mb)->default_value("0"))
+            ("z, zncc", "report zero-normalized cross-correlation peak heights", cxxopts::value<bool>(zncc))
+            ("a, adaptive-levels", "number of adaptive grid refinement levels", cxxopts::value<uint8_t>(adaptive_levels)->default_value("0"))
+            ("refine-peak-ratio", "refine where peak ratio is below this value", cxxopts::value<double>(refinement.minimum_peak_ratio)->default_value("1.2"))
+            ("refine-gradient", "refine where displacement gradient is above this value", cxxopts::value<double>(refinement.maximum_gradient)->default_value("0.1"))
+            ("min-mean", "skip interrogation areas with a mean intensity below this value", cxxopts::value<double>(thresholds.minimum_mean)->default_value("0"))
+            ("min-stddev", "skip interrogation areas with an intensity standard deviation below this value", cxxopts::value<double>(thresholds.minimum_stddev)->default_value("0"))
+            ("min-particles", "skip interrogation areas with fewer particles than this value", cxxopts::value<uint32_t>(thresholds.minimum_particles)->default_value("0"))
             ("loglevel", "log level", cxxopts::value<logger::Level>(log_level)->default_value("INFO"));
 
         options.parse_positional({"input"});
@@ -82,11 +113,58 @@ int main( int argc, char* argv[] )
             return 0;
         }
 
-        if (result.count("input") != 2)
+        const auto input_count = result.count("input");
+        if ( !ensemble && input_count != 2 )
         {
             logger::error("require two input images");
             return 1;
         }
+
+        if ( ensemble && ( input_count < 2 || input_count % 2 != 0 ) )
+        {
+            logger::error("require an even number of input images for ensemble correlation");
+            return 1;
+        }
+
+        if ( ensemble && ( adaptive_levels > 0 || zncc || thresholds.enabled() ) )
+        {
+            logger::error("ensemble correlation doesn't support adaptive grids, zncc or low signal thresholds");
+            return 1;
+        }
+
+        // ensemble spectra are accumulated with algos::FFT
+        if ( ensemble && ( fft_type != "complex" || pad || max_lag != 0 ) )
+        {
+            logger::error("ensemble correlation requires the complex fft type and doesn't support zero-padding or max-lag");
+            return 1;
+        }
+
+        if ( pad && ( zncc || ( fft_type != "complex" && fft_type != "pocket" ) ) )
+        {
+            logger::error("zero-padding requires the complex or pocket fft type and doesn't support zncc");
+            return 1;
+        }
+
+        // zncc normalizes correlation sums; block matching planes hold
+        // similarities of differences instead
+        if ( zncc && fft_type != "complex" && fft_type != "pocket" && fft_type != "direct" )
+        {
+            logger::error("zncc requires the complex, pocket or direct fft type");
+            return 1;
+        }
+
+        if ( sliding_dft > 0 && ( ensemble || pad || adaptive_levels > 0 || thresholds.enabled() ) )
+        {
+            logger::error("sliding-dft doesn't support ensemble correlation, zero-padding, adaptive grids or low signal thresholds");
+            return 1;
+        }
+
+        // sliding updates are applied to spectra from algos::FFT
+        if ( sliding_dft > 0 && fft_type != "complex" )
+        {
+            logger::error("sliding-dft requires the complex fft type");
+            return 1;
+        }
     }
     catch (const std::exception& e)
     {
@@ -100,23 +178,27 @@ int main( int argc, char* argv[] )
     logger::info("input files: {}", core::join(input_files, ", "));
     logger::info("execution: {}", execution);
 
-    // get images
-    std::vector<core::gf_image> images;
-    try {
-        for ( const auto& input_file : input_files )
-        {
-            std::ifstream is(input_file, std::ios::binary);
-            if ( !is.is_open() )
-                core::exception_builder<std::runtime_error>() << "failed to open " << input_file;
+    auto load_image = []( const std::string& input_file ) -> core::gf_image
+                      {
+                          std::ifstream is(input_file, std::ios::binary);
+                          if ( !is.is_open() )
+                              core::exception_builder<std::runtime_error>() << "failed to open " << input_file;
 
-            auto loader{ core::image_loader_registry::instance().find(is) };
-            if ( !loader )
-                core::exception_builder<std::runtime_error>() << "failed to find loader for " << input_file;
+                          auto loader{ core::image_loader_registry::instance().find(is) };
+                          if ( !loader )
+                              core::exception_builder<std::runtime_error>() << "failed to find loader for " << input_file;
 
-            core::gf_image image;
-            loader->load( is, image );
-            images.emplace_back(std::move(image));
-        }
+                          core::gf_image image;
+                          loader->load( is, image );
+                          return image;
+                      };
+
+    // get images; for ensemble correlation only the first pair is
+    // loaded here and the remaining pairs are streamed
+    std::vector<core::gf_image> images;
+    try {
+        for ( size_t i=0; i<2; ++i )
+            images.emplace_back( load_image( input_files[i] ) );
     }
     catch ( std::exception& e )
     {
@@ -146,35 +228,144 @@ int main( int argc, char* argv[] )
         core::point2<double> xy;
         core::vector2<double> vxy;
         double sn = 0.0;
+        double correlation = 0.0;
+        bool low_signal = false;
     };
-    std::vector<point_vector> found_peaks( grid.size() );
+    std::vector<point_vector> found_peaks;
 
-    // wrap correlators
+    // pre-compute window statistics to allow low-signal interrogation
+    // areas to be skipped prior to correlation, and to normalize
+    // correlation peaks
+    std::vector<algos::window_statistics> statistics;
+    if ( thresholds.enabled() || zncc )
+    {
+        for ( const auto& image : images )
+            statistics.emplace_back( image );
+    }
+    if ( thresholds.enabled() )
+        logger::info("skipping low signal areas: mean < {}, stddev < {}, particles < {}",
+                     thresholds.minimum_mean, thresholds.minimum_stddev, thresholds.minimum_particles);
+    std::atomic<size_t> skipped = 0;
+
+    // spatial-domain and padded correlators only evaluate the lags
+    // that will be searched
+    auto search_radius = [limit_search, max_lag]( const core::size& s ) -> uint32_t
+                         {
+                             if ( max_lag != 0 )
+                                 return max_lag;
+
+                             return limit_search ? std::min( s.width(), s.height() )/4 : std::max( s.width(), s.height() );
+                         };
+
+    // block matching compares 8-bit windows using byte SIMD
+    // instructions; deeper frames are scaled into 8 bits
+    double byte_scale = 1.0;
+    if ( fft_type == "sad" || fft_type == "mqd" )
+    {
+        double maximum = 0;
+        for ( const auto& image : images )
+            maximum = std::max<double>( maximum, std::get<1>( algos::image_min_max( image ) ) );
+        if ( maximum > 255 )
+        {
+            byte_scale = 255 / maximum;
+            logger::info("block matching frames scaled by {} into 8 bits", byte_scale);
+        }
+    }
+    auto to_bytes = [byte_scale]( const core::gf_image& im )
+                    {
+                        core::g8_image result{ im.size() };
+                        for ( size_t i=0; i<im.pixel_count(); ++i )
+                            result[i] = static_cast<uint8_t>( std::clamp( std::round( im[i] * byte_scale ), 0.0, 255.0 ) );
+
+                        return result;
+                    };
+
+    // wrap correlators; each is created for a specific interrogation size
     using correlator_t = std::function<core::gf_image(const core::gf_image&, const core::gf_image&)>;
-    std::unordered_map<std::string, correlator_t> correlators = {
+    using correlator_factory_t = std::function<correlator_t(const core::size&)>;
+    std::unordered_map<std::string, correlator_factory_t> correlators = {
         {"complex",
-         [ia](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+         [pad, &search_radius](const core::size& s) -> correlator_t
              {
-                 static algos::FFT fft{ ia };
-                 return fft.cross_correlate(im_a, im_b);
+                 if ( pad )
+                 {
+                     // pruned transforms only evaluate the searched lags
+                     auto fft = std::make_shared<algos::FFT>( core::size{ 2*s.width(), 2*s.height() } );
+                     return [fft, max_lag = search_radius( s )](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                         {
+                             return fft->cross_correlate_padded(im_a, im_b, max_lag);
+                         };
+                 }
+
+                 auto fft = std::make_shared<algos::FFT>( s );
+                 return [fft](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return fft->cross_correlate(im_a, im_b);
+                     };
              } },
         {"real",
-         [ia](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+         [](const core::size& s) -> correlator_t
              {
-                 static algos::FFT fft{ ia };
-                 return fft.cross_correlate_real(im_a, im_b);
+                 auto fft = std::make_shared<algos::FFT>( s );
+                 return [fft](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return fft->cross_correlate_real(im_a, im_b);
+                     };
              } },
         {"pocket",
-         [ia](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+         [pad, &search_radius](const core::size& s) -> correlator_t
              {
-                 static algos::PocketFFT fft{ ia };
-                 return fft.cross_correlate(im_a, im_b);
+                 if ( pad )
+                 {
+                     // pruned transforms only evaluate the searched lags
+                     auto fft = std::make_shared<algos::PocketFFT>( core::size{ 2*s.width(), 2*s.height() } );
+                     return [fft, max_lag = search_radius( s )](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                         {
+                             return fft->cross_correlate_padded(im_a, im_b, max_lag);
+                         };
+                 }
+
+                 auto fft = std::make_shared<algos::PocketFFT>( s );
+                 return [fft](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return fft->cross_correlate(im_a, im_b);
+                     };
              } },
         {"pocket_real",
-         [ia](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+         [](const core::size& s) -> correlator_t
+             {
+                 auto fft = std::make_shared<algos::PocketFFT>( s );
+                 return [fft](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return fft->cross_correlate_real(im_a, im_b);
+                     };
+             } },
+        {"direct",
+         [&search_radius](const core::size& s) -> correlator_t
+             {
+                 auto correlator = std::make_shared<algos::DirectCorrelation>( s, search_radius( s ) );
+                 return [correlator](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return correlator->cross_correlate(im_a, im_b);
+                     };
+             } },
+        {"sad",
+         [&search_radius, &to_bytes](const core::size& s) -> correlator_t
              {
-                 static algos::PocketFFT fft{ ia };
-                 return fft.cross_correlate_real(im_a, im_b);
+                 auto matcher = std::make_shared<algos::BlockMatching>( s, search_radius( s ), algos::match_metric::SAD );
+                 return [matcher, &to_bytes](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return matcher->cross_correlate(to_bytes(im_a), to_bytes(im_b));
+                     };
+             } },
+        {"mqd",
+         [&search_radius, &to_bytes](const core::size& s) -> correlator_t
+             {
+                 auto matcher = std::make_shared<algos::BlockMatching>( s, search_radius( s ), algos::match_metric::MQD );
+                 return [matcher, &to_bytes](const core::gf_image& im_a, const core::gf_image& im_b) -> core::gf_image
+                     {
+                         return matcher->cross_correlate(to_bytes(im_a), to_bytes(im_b));
+                     };
              } } };
 
     if (correlators.count(fft_type) == 0)
@@ -183,134 +374,436 @@ int main( int argc, char* argv[] )
         return 1;
     }
 
-    auto correlator = correlators[fft_type];
-
-    // processing strategy
-    auto processor = [&images, &found_peaks, correlator = std::move(correlator), limit_search]( size_t i, const core::rect& ia )
-                     {
-                         const auto view_a{ core::extract( images[0], ia ) };
-                         const auto view_b{ core::extract( images[1], ia ) };
-
-                         // prepare & correlate
-                         // output of correlation has lost positional information
-                         const core::gf_image output{ correlator( view_a, view_b ) };
-
-                         // find peaks
-                         constexpr uint16_t num_peaks = 2;
-                         constexpr uint16_t radius = 1;
+    // one correlator per refinement level; each level halves the
+    // interrogation size
+    std::vector<std::tuple<core::size, correlator_t>> level_correlators;
+    try {
+        for ( uint8_t level = 0; level <= adaptive_levels; ++level )
+        {
+            const core::size level_size{ ia.width() >> level, ia.height() >> level };
+            level_correlators.emplace_back( level_size, correlators[fft_type]( level_size ) );
+        }
+    }
+    catch ( std::exception& e )
+    {
+        logger::error("failed to create correlator: {}", e.what());
+        return 1;
+    }
 
-                         core::peaks_t<core::g_f> peaks;
+    auto correlator_for = [&level_correlators]( const core::size& s ) -> const correlator_t&
+                          {
+                              for ( const auto& [level_size, correlator] : level_correlators )
+                                  if ( level_size == s )
+                                      return correlator;
+
+                              core::exception_builder<std::runtime_error>() << "no correlator for size " << s;
+                              return std::get<1>(level_correlators.front());
+                          };
+
+    // find the displacement of interrogation area \a ia from its
+    // correlation plane \a output
+    auto evaluate = [&images, limit_search, zncc]( const core::rect& ia,
+                                                  const core::gf_image& output,
+                                                  const std::vector<algos::window_stats>& stats,
+                                                  point_vector& found )
+                    {
+                        // find peaks
+                        constexpr uint16_t num_peaks = 2;
+                        constexpr uint16_t radius = 1;
+
+                        core::fixed_peaks_t<core::g_f, radius> peaks;
+
+                        if (limit_search)
+                        {
+                            // reduce search radius
+                            auto centre = core::create_image_view( output, output.rect().dilate(0.5) );
+                            peaks = core::find_fixed_peaks<radius>( centre, num_peaks );
+                        } else {
+                            peaks = core::find_fixed_peaks<radius>( output, num_peaks );
+                        }
+
+                        // sub-pixel fitting
+                        if ( peaks.size() != num_peaks )
+                        {
+                            logger::error("failed to find a peak for ia: {}", ia);
+                            return;
+                        }
+
+                        point_vector result;
+                        auto bl = ia.bottomLeft();
+                        auto midpoint = ia.midpoint();
+                        auto peak_location = core::fit_simple_gaussian( peaks[0] );
+
+                        result.xy = midpoint;
+                        result.vxy = { midpoint[0] - (bl[0] + peak_location[0]), midpoint[1] - (bl[1] + peak_location[1]) };
+
+                        // convert from image normal cartesian
+                        result.xy[1] = images[0].height() - result.xy[1];
+
+                        // normalization is a positive affine map so
+                        // only the peak heights need to be normalized
+                        double first = peaks[0][ {1, 1} ];
+                        double second = peaks[1][ {1, 1} ];
+                        if ( zncc )
+                        {
+                            const algos::zncc_normalization n{
+                                ia.size(), stats[0].mean, stats[0].stddev, stats[1].mean, stats[1].stddev };
+                            first = n( first );
+                            second = n( second );
+                            result.correlation = first;
+                        }
+
+                        // find s/n (or rather, highest to next highest peak)
+                        if ( second > 0 )
+                            result.sn = first/second;
+
+                        found = std::move(result);
+                    };
+
+    // processing strategy; windows are copied from \a frame_a and \a
+    // frame_b, which are either the images or bands of them
+    auto process_from = [&images, &correlator_for, &evaluate, &statistics, &thresholds, &skipped]( const auto& frame_a,
+                                                                                                 const auto& frame_b,
+                                                                                                 const core::rect& ia,
+                                                                                                 point_vector& found )
+                        {
+                            // early-out for areas without enough signal
+                            std::vector<algos::window_stats> stats;
+                            for ( const auto& s : statistics )
+                            {
+                                stats.push_back( s( ia ) );
+                                if ( algos::is_low_signal( stats.back(), thresholds ) )
+                                {
+                                    found.xy = ia.midpoint();
+                                    found.xy[1] = images[0].height() - found.xy[1];
+                                    found.low_signal = true;
+                                    ++skipped;
+                                    return;
+                                }
+                            }
+
+                            const auto view_a{ frame_a.extract( ia ) };
+                            const auto view_b{ frame_b.extract( ia ) };
+
+                            // prepare & correlate
+                            // output of correlation has lost positional information
+                            const core::gf_image output{ correlator_for( ia.size() )( view_a, view_b ) };
+                            evaluate( ia, output, stats, found );
+                        };
+
+    // copies windows from the whole of an image
+    struct whole_image
+    {
+        const core::gf_image& im;
+        core::gf_image extract( const core::rect& r ) const { return core::extract( im, r ); }
+    };
 
-                         if (limit_search)
-                         {
-                             // reduce search radius
-                             auto centre = core::create_image_view( output, output.rect().dilate(0.5) );
-                             peaks = core::find_peaks( centre, num_peaks, radius );
-                         } else {
-                             peaks = core::find_peaks( output, num_peaks, radius );
-                         }
+    auto processor = [&images, &process_from]( const core::rect& ia, point_vector& found )
+                     {
+                         process_from( whole_image{ images[0] }, whole_image{ images[1] }, ia, found );
+                     };
 
-                         // sub-pixel fitting
-                         if ( peaks.size() != num_peaks )
+    // [first, last) of each row of \a grid i.e. runs of interrogation
+    // areas with the same bottom
+    auto grid_rows = []( const std::vector<core::rect>& grid )
+                     {
+                         std::vector<std::tuple<size_t, size_t>> rows;
+                         for ( size_t i=0; i<grid.size(); ++i )
                          {
-                             logger::error("failed to find a peak for ia: {}", ia);
-                             return;
+                             if ( i == 0 || grid[i].bottom() != grid[i - 1].bottom() )
+                                 rows.emplace_back( i, i + 1 );
+                             else
+                                 std::get<1>( rows.back() ) = i + 1;
                          }
 
-                         point_vector result;
-                         auto bl = ia.bottomLeft();
-                         auto midpoint = ia.midpoint();
-                         auto peak = peaks[0];
-                         auto peak_location = core::fit_simple_gaussian( peak );
-
-                         result.xy = midpoint;
-                         result.vxy = { midpoint[0] - (bl[0] + peak_location[0]), midpoint[1] - (bl[1] + peak_location[1]) };
-
-                         // convert from image normal cartesian
-                         result.xy[1] = images[0].height() - result.xy[1];
-
-                         // find s/n (or rather, highest to next highest peak)
-                         if ( peaks[1][ {1, 1} ] > 0 )
-                             result.sn = peaks[0][ {1, 1} ]/peaks[1][ {1, 1} ];
-
-                         found_peaks[i] = std::move(result);
+                         return rows;
                      };
 
+    // process all of \a grid, storing the results in \a results
+    auto run = [&]( const std::vector<core::rect>& grid, std::vector<point_vector>& results )
+               {
+                   results.resize( grid.size() );
+
+                   // check execution
+                   if (thread_count <= 1)
+                   {
+                       logger::info("processing using single thread");
+                       size_t i = 0;
+                       for ( const auto& ia : grid )
+                       {
+                           processor(ia, results[i++]);
+                       }
+                   }
+                   else
+#if defined(ASYNCPLUSPLUS)
+                   if ( execution == "async++" )
+                   {
+                       logger::info("processing using async++");
+                       std::atomic<size_t> i = 0;
+                       async::parallel_for( grid,
+                                            [&i, &results, processor] (const core::rect& ia)
+                                            {
+                                                processor(ia, results[i++]);
+                                            } );
+                   }
+                   else
+#endif
+                   if ( execution == "pool" )
+                   {
+                       logger::info("processing using thread pool");
+                       ThreadPool pool( thread_count );
+
+                       size_t i = 0;
+                       for ( const auto& ia : grid )
+                       {
+                           pool.enqueue( [i, ia, &results, &processor](){ processor(ia, results[i]); } );
+                           ++i;
+                       }
+                   }
+                   else if ( execution == "bands" )
+                   {
+                       logger::info("processing using bands");
+
+                       // each grid row copies the band of rows it covers
+                       // once; windows are then copied from the band, and
+                       // rows shared with the previous grid row are reused
+                       const auto rows = grid_rows( grid );
+                       core::parallel_for_blocks(
+                           rows.size(),
+                           [&]( size_t begin, size_t end )
+                           {
+                               core::image_band<core::g_f> band_a{ images[0] };
+                               core::image_band<core::g_f> band_b{ images[1] };
+                               for ( size_t r=begin; r<end; ++r )
+                               {
+                                   const auto [first, last] = rows[r];
+                                   int32_t top = grid[first].top();
+                                   for ( size_t i=first; i<last; ++i )
+                                       top = std::max( top, grid[i].top() );
+
+                                   const int32_t bottom = grid[first].bottom();
+                                   band_a.load( bottom, top - bottom );
+                                   band_b.load( bottom, top - bottom );
+                                   for ( size_t i=first; i<last; ++i )
+                                       process_from( band_a, band_b, grid[i], results[i] );
+                               }
+                           },
+                           1 );
+                   }
+                   else if ( execution == "bulk-pool" )
+                   {
+                       logger::info("processing using thread pool with bulk split");
+                       ThreadPool pool( thread_count );
+
+                       // - split the grid into thread_count chunks
+                       // - wrap each chunk into a processing for loop and push to thread
+
+                       // ensure we don't miss grid locations due to rounding
+                       size_t chunk_size = grid.size()/thread_count;
+                       std::vector<size_t> chunk_sizes( thread_count, chunk_size );
+                       chunk_sizes.back() = grid.size() - (thread_count-1)*chunk_size;
+
+                       logger::debug("chunk sizes: {}", core::join(chunk_sizes, ", "));
+
+                       size_t i = 0;
+                       for ( const auto& chunk_size_ : chunk_sizes )
+                       {
+                           pool.enqueue(
+                               [i, chunk_size_, &grid, &results, &processor]() {
+                                   for ( size_t j=i; j<i + chunk_size_; ++j )
+                                       processor(grid[j], results[j]);
+                               } );
+                           i += chunk_size_;
+                       }
+                   }
+               };
+
+    // process \a grid a row at a time, deriving the spectra of each
+    // interrogation area from those of its left neighbour
+    auto run_sliding = [&]( const std::vector<core::rect>& grid, std::vector<point_vector>& results )
+                       {
+                           logger::info("processing using sliding DFT, refreshing every {} areas", sliding_dft);
+                           results.resize( grid.size() );
+
+                           const auto rows = grid_rows( grid );
+
+                           const algos::FFT fft( ia );
+                           core::parallel_for_blocks(
+                               rows.size(),
+                               [&]( size_t begin, size_t end )
+                               {
+                                   algos::SlidingDFT sliding_a( ia, sliding_dft );
+                                   algos::SlidingDFT sliding_b( ia, sliding_dft );
+                                   for ( size_t r=begin; r<end; ++r )
+                                   {
+                                       const auto [first, last] = rows[r];
+                                       sliding_a.start( images[0], grid[first] );
+                                       sliding_b.start( images[1], grid[first] );
+                                       for ( size_t i=first; i<last; ++i )
+                                       {
+                                           if ( i != first )
+                                           {
+                                               const uint32_t step = grid[i].left() - grid[i - 1].left();
+                                               sliding_a.advance( step );
+                                               sliding_b.advance( step );
+                                           }
+
+                                           std::vector<algos::window_stats> stats;
+                                           for ( const auto& s : statistics )
+                                               stats.push_back( s( grid[i] ) );
+
+                                           evaluate( grid[i], fft.cross_correlate_spectra( sliding_a.spectrum(), sliding_b.spectrum() ), stats, results[i] );
+                                       }
+                                   }
+                               },
+                               1 );
+                       };
+
+    // interrogation areas correlated or skipped, including those of
+    // every adaptive refinement level
+    size_t evaluated = 0;
+
     const auto t1 = std::chrono::high_resolution_clock::now();
 
-    // check execution
-    if (thread_count <= 1)
+    if ( ensemble )
     {
-        logger::info("processing using single thread");
-        size_t i = 0;
-        for ( const auto& ia : grid )
+        // accumulate spectra of each pair, then locate the peak of each
+        // averaged correlation plane
+        algos::EnsembleCorrelation<> ensemble_correlation{ grid };
+
+        // frames that appear in more than one pair, e.g. "a b b c c d",
+        // reuse the spectra of their interrogation areas
+        algos::spectrum_cache cache{ size_t{spectrum_cache_mb} << 20 };
+        std::unordered_map<std::string, uint64_t> frame_ids;
+        auto add = [&]( const core::gf_image& a, const std::string& file_a, const core::gf_image& b, const std::string& file_b )
+                   {
+                       if ( spectrum_cache_mb == 0 )
+                       {
+                           ensemble_correlation.add( a, b );
+                           return;
+                       }
+
+                       const auto id_a = frame_ids.try_emplace( file_a, frame_ids.size() ).first->second;
+                       const auto id_b = frame_ids.try_emplace( file_b, frame_ids.size() ).first->second;
+                       ensemble_correlation.add( a, id_a, b, id_b, cache );
+                   };
+
+        try {
+            add( images[0], input_files[0], images[1], input_files[1] );
+            for ( size_t i=2; i<input_files.size(); i+=2 )
+            {
+                const auto image_a{ load_image( input_files[i] ) };
+                const auto image_b{ load_image( input_files[i + 1] ) };
+                if ( image_a.size() != images[0].size() || image_b.size() != images[0].size() )
+                    core::exception_builder<std::runtime_error>()
+                        << "image sizes don't match: " << image_a.size() << ", " << image_b.size() << ", " << images[0].size();
+
+                add( image_a, input_files[i], image_b, input_files[i + 1] );
+            }
+        }
+        catch ( std::exception& e )
         {
-            processor(i++, ia);
+            logger::error("failed to accumulate image pair: {}", e.what());
+            return 1;
+        }
+        logger::info("accumulated {} image pairs", ensemble_correlation.pair_count());
+        if ( spectrum_cache_mb > 0 )
+            logger::info("spectrum cache: {} hits, {} misses", cache.hits(), cache.misses());
+
+        // evaluate in thread_count chunks, as for bulk-pool
+        found_peaks.resize( grid.size() );
+        auto evaluate_range = [&]( size_t begin, size_t end )
+                              {
+                                  for ( size_t i=begin; i<end; ++i )
+                                      evaluate( grid[i], ensemble_correlation.correlation( i ), {}, found_peaks[i] );
+                              };
+        if ( thread_count <= 1 )
+            evaluate_range( 0, grid.size() );
+        else
+        {
+            ThreadPool pool( thread_count );
+            const size_t chunk_size = ( grid.size() + thread_count - 1 )/thread_count;
+            for ( size_t i=0; i<grid.size(); i+=chunk_size )
+                pool.enqueue( [&evaluate_range, i, last = std::min( i + chunk_size, grid.size() )](){ evaluate_range( i, last ); } );
         }
     }
-    else
-#if defined(ASYNCPLUSPLUS)
-    if ( execution == "async++" )
+    else if ( sliding_dft > 0 )
+    {
+        run_sliding( grid, found_peaks );
+    }
+    else if ( adaptive_levels == 0 )
     {
-        logger::info("processing using async++");
-        std::atomic<size_t> i = 0;
-        async::parallel_for( grid,
-                             [&i, processor] (const core::rect& ia)
-                             {
-                                 processor(i++, ia);
-                             } );
+        run( grid, found_peaks );
     }
     else
-#endif
-    if ( execution == "pool" )
     {
-        logger::info("processing using thread pool");
-        ThreadPool pool( thread_count );
+        // start with the uniform grid and refine where the peak ratio is
+        // poor or the displacement gradient is high
+        const core::size minimum_size{ ia.width() >> adaptive_levels, ia.height() >> adaptive_levels };
+        core::adaptive_grid<point_vector> adaptive{ images[0].size(), ia, overlap, minimum_size };
 
-        size_t i = 0;
-        for ( const auto& ia : grid )
+        auto pending = adaptive.leaves();
+        for ( uint8_t level = 0; !pending.empty(); ++level )
         {
-            pool.enqueue( [i, ia, &processor](){ processor(i, ia); } );
-            ++i;
+            std::vector<point_vector> results;
+            run( adaptive.rects( pending ), results );
+            evaluated += pending.size();
+            for ( size_t i=0; i<pending.size(); ++i )
+                adaptive[ pending[i] ].value = std::move( results[i] );
+
+            // low signal areas are neither refined nor used to find gradients
+            for ( const auto& i : pending )
+                if ( adaptive[i].value->low_signal )
+                    adaptive[i].value.reset();
+
+            if ( level == adaptive_levels )
+                break;
+
+            pending = core::refine_by_quality(
+                adaptive,
+                refinement,
+                [](const point_vector& pv){ return pv.vxy; },
+                [](const point_vector& pv){ return pv.sn; } );
+            logger::info("refinement level {}: {} new interrogation areas", level + 1, pending.size());
         }
-    }
-    else if ( execution == "bulk-pool" )
-    {
-        logger::info("processing using thread pool with bulk split");
-        ThreadPool pool( thread_count );
-
-        // - split the grid into thread_count chunks
-        // - wrap each chunk into a processing for loop and push to thread
 
-        // ensure we don't miss grid locations due to rounding
-        size_t chunk_size = grid.size()/thread_count;
-        std::vector<size_t> chunk_sizes( thread_count, chunk_size );
-        chunk_sizes.back() = grid.size() - (thread_count-1)*chunk_size;
-
-        logger::debug("chunk sizes: {}", core::join(chunk_sizes, ", "));
-
-        size_t i = 0;
-        for ( const auto& chunk_size_ : chunk_sizes )
+        for ( const auto& leaf : adaptive.leaves() )
         {
-            pool.enqueue(
-                [i, chunk_size_, &grid, &processor]() {
-                    for ( size_t j=i; j<i + chunk_size_; ++j )
-                        processor(j, grid[j]);
-                } );
-            i += chunk_size_;
+            if ( adaptive[ leaf ].value )
+            {
+                found_peaks.push_back( *adaptive[ leaf ].value );
+            }
+            else
+            {
+                point_vector flagged;
+                flagged.xy = adaptive[ leaf ].r.midpoint();
+                flagged.xy[1] = images[0].height() - flagged.xy[1];
+                flagged.low_signal = true;
+                found_peaks.push_back( flagged );
+            }
         }
     }
 
+    if ( adaptive_levels == 0 )
+        evaluated = found_peaks.size();
+
     const auto t2 = std::chrono::high_resolution_clock::now();
     const std::chrono::duration<double, std::micro> total_us = t2 - t1;
     logger::info(
         "processing time: {}us, {}us per interrogation area",
         total_us,
         total_us/found_peaks.size());
+    if ( thresholds.enabled() )
+        logger::info("skipped {} of {} interrogation areas due to low signal", skipped.load(), evaluated);
 
     // dump output
     for ( const auto& pv : found_peaks )
-        std::cout << pv.xy[0] << ", " << pv.xy[1] << ", " << pv.vxy[0] << ", " << pv.vxy[1] << ", " << pv.sn << "\n";
+    {
+        std::cout << pv.xy[0] << ", " << pv.xy[1] << ", " << pv.vxy[0] << ", " << pv.vxy[1] << ", " << pv.sn;
+        if ( zncc )
+            std::cout << ", " << pv.correlation;
+        std::cout << "\n";
+    }
 
 
     return 0;
@@ -0,0 +1,234 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "algos/direct_correlation.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/pixel_types.h"
+#include "core/size.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    /// dissimilarity measure used for block matching
+    enum class match_metric {
+        SAD,
+        MQD
+    };
+
+    namespace detail {
+
+        /// \returns the sum of absolute differences of \a a and \a b,
+        /// each of length \a n
+        template < typename T >
+        inline double sad( const T* a, const T* b, size_t n )
+        {
+            double result = 0;
+            for ( size_t i=0; i<n; ++i )
+                result += std::abs( static_cast<double>( a[i] ) - static_cast<double>( b[i] ) );
+
+            return result;
+        }
+
+        inline double sad( const uint8_t* a, const uint8_t* b, size_t n )
+        {
+            size_t i = 0;
+            uint64_t result = 0;
+#if defined(__AVX2__)
+            __m256i acc = _mm256_setzero_si256();
+            for ( ; i + 32 <= n; i += 32 )
+                acc = _mm256_add_epi64( acc, _mm256_sad_epu8( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + i ) ),
+                                                              _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + i ) ) ) );
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), acc );
+            for ( const auto lane : lanes )
+                result += lane;
+#elif defined(__SSE2__)
+            __m128i acc = _mm_setzero_si128();
+            for ( ; i + 16 <= n; i += 16 )
+                acc = _mm_add_epi64( acc, _mm_sad_epu8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + i ) ),
+                                                        _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + i ) ) ) );
+            alignas(16) uint64_t lanes[2];
+            _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), acc );
+            result = lanes[0] + lanes[1];
+#endif
+            for ( ; i<n; ++i )
+                result += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+
+            return result;
+        }
+
+        /// \returns the sum of squared differences of \a a and \a b,
+        /// each of length \a n
+        template < typename T >
+        inline double ssd( const T* a, const T* b, size_t n )
+        {
+            double result = 0;
+            for ( size_t i=0; i<n; ++i )
+            {
+                const double d = static_cast<double>( a[i] ) - static_cast<double>( b[i] );
+                result += d * d;
+            }
+
+            return result;
+        }
+
+        inline double ssd( const uint8_t* a, const uint8_t* b, size_t n )
+        {
+            size_t i = 0;
+            uint64_t result = 0;
+#if defined(__AVX2__)
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i acc = _mm256_setzero_si256();
+            for ( ; i + 32 <= n; i += 32 )
+            {
+                const __m256i va = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + i ) );
+                const __m256i vb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + i ) );
+                const __m256i lo = _mm256_sub_epi16( _mm256_unpacklo_epi8( va, zero ), _mm256_unpacklo_epi8( vb, zero ) );
+                const __m256i hi = _mm256_sub_epi16( _mm256_unpackhi_epi8( va, zero ), _mm256_unpackhi_epi8( vb, zero ) );
+                acc = _mm256_add_epi32( acc, _mm256_madd_epi16( lo, lo ) );
+                acc = _mm256_add_epi32( acc, _mm256_madd_epi16( hi, hi ) );
+            }
+            alignas(32) uint32_t lanes[8];
+            _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), acc );
+            for ( const auto lane : lanes )
+                result += lane;
+#elif defined(__SSE2__)
+            const __m128i zero = _mm_setzero_si128();
+            __m128i acc = _mm_setzero_si128();
+            for ( ; i + 16 <= n; i += 16 )
+            {
+                const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + i ) );
+                const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + i ) );
+                const __m128i lo = _mm_sub_epi16( _mm_unpacklo_epi8( va, zero ), _mm_unpacklo_epi8( vb, zero ) );
+                const __m128i hi = _mm_sub_epi16( _mm_unpackhi_epi8( va, zero ), _mm_unpackhi_epi8( vb, zero ) );
+                acc = _mm_add_epi32( acc, _mm_madd_epi16( lo, lo ) );
+                acc = _mm_add_epi32( acc, _mm_madd_epi16( hi, hi ) );
+            }
+            alignas(16) uint32_t lanes[4];
+            _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), acc );
+            for ( const auto lane : lanes )
+                result += lane;
+#endif
+            for ( ; i<n; ++i )
+            {
+                const int32_t d = static_cast<int32_t>( a[i] ) - b[i];
+                result += d * d;
+            }
+
+            return result;
+        }
+
+        /// \returns pixel data as the underlying value type; greyscale
+        /// pixels are packed so this is safe
+        template < typename ContainedT >
+        inline const typename ContainedT::value_t* values( const ContainedT* p )
+        {
+            static_assert( sizeof(ContainedT) == sizeof(typename ContainedT::value_t) );
+            return reinterpret_cast<const typename ContainedT::value_t*>( p );
+        }
+
+    }
+
+    /// Block matching by sum of absolute differences (SAD) or minimum
+    /// quadratic difference (MQD) over lags within +/- \a search_radius
+    /// pixels of zero displacement; a cheap alternative to correlation
+    /// e.g. for previews. 8-bit images are matched using byte SIMD
+    /// instructions.
+    ///
+    /// Windows are not wrapped: each lag compares only the overlapping
+    /// parts of the windows and the difference is averaged over the
+    /// overlap. To allow the output to be used in place of that of
+    /// FFT::cross_correlate (i.e. with find_peaks and
+    /// fit_simple_gaussian) it is converted to a similarity of
+    /// 1/(1 + d) which peaks at the best match, with zero displacement
+    /// at the centre of the plane; lags that are not evaluated are zero.
+    ///
+    /// This class is thread-safe
+    class BlockMatching
+    {
+        core::size size_;
+        uint32_t search_radius_;
+        match_metric metric_;
+
+    public:
+        BlockMatching( const core::size& size, uint32_t search_radius, match_metric metric = match_metric::SAD )
+            : size_(size)
+            , search_radius_(search_radius)
+            , metric_(metric)
+        {
+            if ( size_.area() == 0 )
+                exception_builder<std::runtime_error>() << "dimensions must be non-zero: " << size_;
+        }
+
+        inline const core::size& size() const { return size_; }
+        inline uint32_t search_radius() const { return search_radius_; }
+        inline match_metric metric() const { return metric_; }
+
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate( const ImageT<ContainedT>& a,
+                         const ImageT<ContainedT>& b ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( a.size() != size_ || b.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is different from expected: " << a.size() << ", " << b.size() << ", " << size_;
+            }
+
+            using value_t = typename OutT::pixel_t::value_t;
+            const auto [width, height] = size_.components();
+            const auto [min_x, max_x] = detail::lag_range( width, search_radius_ );
+            const auto [min_y, max_y] = detail::lag_range( height, search_radius_ );
+
+            OutT output{ size_ };
+            for ( int32_t dy=min_y; dy<=max_y; ++dy )
+            {
+                const uint32_t y0 = std::max( 0, -dy );
+                const uint32_t y1 = std::min<int32_t>( height, height - dy );
+                auto* out = output.line( ( dy + height/2 + height ) % height );
+                for ( int32_t dx=min_x; dx<=max_x; ++dx )
+                {
+                    const uint32_t x0 = std::max( 0, -dx );
+                    const uint32_t x1 = std::min<int32_t>( width, width - dx );
+                    double sum = 0;
+                    for ( uint32_t y=y0; y<y1; ++y )
+                    {
+                        const auto* line_a = detail::values( a.line( y ) + x0 );
+                        const auto* line_b = detail::values( b.line( y + dy ) + x0 + dx );
+                        sum += metric_ == match_metric::SAD
+                            ? detail::sad( line_a, line_b, x1 - x0 )
+                            : detail::ssd( line_a, line_b, x1 - x0 );
+                    }
+
+                    const double d = sum / ( ( x1 - x0 ) * ( y1 - y0 ) );
+                    out[ ( dx + width/2 + width ) % width ] = static_cast<value_t>( 1.0 / ( 1.0 + d ) );
+                }
+            }
+
+            return output;
+        }
+    };
+
+}
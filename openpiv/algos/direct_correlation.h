@@ -0,0 +1,265 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "algos/fft.h"
+#include "algos/fft_common.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/pixel_types.h"
+#include "core/size.h"
+#include "core/util.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    namespace detail {
+
+        /// \returns the dot product of \a a and \a b, each of length \a n
+        inline double dot( const double* a, const double* b, size_t n )
+        {
+            size_t i = 0;
+            double result = 0;
+#if defined(__AVX__)
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            for ( ; i + 8 <= n; i += 8 )
+            {
+#if defined(__FMA__)
+                acc0 = _mm256_fmadd_pd( _mm256_loadu_pd( a + i ), _mm256_loadu_pd( b + i ), acc0 );
+                acc1 = _mm256_fmadd_pd( _mm256_loadu_pd( a + i + 4 ), _mm256_loadu_pd( b + i + 4 ), acc1 );
+#else
+                acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a + i ), _mm256_loadu_pd( b + i ) ) );
+                acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( a + i + 4 ), _mm256_loadu_pd( b + i + 4 ) ) );
+#endif
+            }
+            acc0 = _mm256_add_pd( acc0, acc1 );
+            const __m128d sum2 = _mm_add_pd( _mm256_castpd256_pd128( acc0 ), _mm256_extractf128_pd( acc0, 1 ) );
+            result = _mm_cvtsd_f64( _mm_add_sd( sum2, _mm_unpackhi_pd( sum2, sum2 ) ) );
+#elif defined(__SSE2__)
+            __m128d acc0 = _mm_setzero_pd();
+            __m128d acc1 = _mm_setzero_pd();
+            for ( ; i + 4 <= n; i += 4 )
+            {
+                acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a + i ), _mm_loadu_pd( b + i ) ) );
+                acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( a + i + 2 ), _mm_loadu_pd( b + i + 2 ) ) );
+            }
+            acc0 = _mm_add_pd( acc0, acc1 );
+            result = _mm_cvtsd_f64( _mm_add_sd( acc0, _mm_unpackhi_pd( acc0, acc0 ) ) );
+#endif
+            for ( ; i<n; ++i )
+                result += a[i] * b[i];
+
+            return result;
+        }
+
+    }
+
+    /// Spatial-domain correlation that only evaluates lags within
+    /// +/- \a max_lag pixels of zero displacement; this is cheaper
+    /// than an FFT when the expected displacement is small.
+    ///
+    /// The output matches that of FFT::cross_correlate, including
+    /// circular wrapping, the position of zero displacement at the
+    /// centre of the plane and the factor of N from the unscaled
+    /// inverse transform, so the correlators are interchangeable;
+    /// lags that are not evaluated are zero.
+    ///
+    /// If the lag range is large enough that an FFT is estimated to
+    /// be cheaper (\sa prefer_direct) and the size is a power of 2
+    /// then an FFT is used instead.
+    ///
+    /// This class is thread-safe
+    class DirectCorrelation
+    {
+        core::size size_;
+        uint32_t max_lag_;
+        std::optional<FFT> fft_;
+
+        /// storage for intermediate data
+        struct data_t
+        {
+            std::vector<double> a;
+            std::vector<double> b;
+        };
+
+        data_t& cache() const
+        {
+            thread_local static data_t data;
+            return data;
+        }
+
+    public:
+        /// cost of an FFT cross-correlation (three transforms) per
+        /// N.log2(N), relative to a direct multiply-add; measured
+        /// for 16x16 to 64x64 windows
+        static constexpr double fft_cost_factor = 20.0;
+
+        DirectCorrelation( const core::size& size, uint32_t max_lag )
+            : size_(size)
+            , max_lag_(max_lag)
+        {
+            if ( size_.area() == 0 )
+                exception_builder<std::runtime_error>() << "dimensions must be non-zero: " << size_;
+
+            if ( !prefer_direct( size_, max_lag_ ) &&
+                 is_pow2( size_.width() ) && is_pow2( size_.height() ) )
+                fft_.emplace( size_ );
+        }
+
+        /// \returns true if evaluating lags within +/- \a max_lag is
+        /// estimated to be cheaper than an FFT cross-correlation of
+        /// windows of size \a size
+        static bool prefer_direct( const core::size& size, uint32_t max_lag )
+        {
+            const double n = size.area();
+            const double lags_x = 2.0 * std::min( max_lag, size.width()/2 ) + 1;
+            const double lags_y = 2.0 * std::min( max_lag, size.height()/2 ) + 1;
+            const double direct_cost = lags_x * lags_y * n;
+            const double fft_cost = fft_cost_factor * n * std::log2( std::max( n, 2.0 ) );
+
+            return direct_cost <= fft_cost;
+        }
+
+        inline const core::size& size() const { return size_; }
+        inline uint32_t max_lag() const { return max_lag_; }
+
+        /// \returns true if correlation is delegated to an FFT
+        inline bool uses_fft() const { return fft_.has_value(); }
+
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename ValueT = arithmetic_t<typename ContainedT::value_t>,
+                   typename OutT = image<g<ValueT>>,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate( const ImageT<ContainedT>& a,
+                         const ImageT<ContainedT>& b ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( a.size() != size_ || b.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is different from expected: " << a.size() << ", " << b.size() << ", " << size_;
+            }
+
+            if ( fft_ )
+                return fft_->cross_correlate<ImageT, ContainedT, ValueT, OutT>( a, b );
+
+            const auto [width, height] = size_.components();
+
+            // copy a, and b with each row repeated so that a circular
+            // shift of a row is contiguous
+            auto& [buffer_a, buffer_b] = cache();
+            buffer_a.resize( size_.area() );
+            buffer_b.resize( 2 * size_.area() );
+            for ( uint32_t h=0; h<height; ++h )
+            {
+                const ContainedT* line_a = a.line( h );
+                const ContainedT* line_b = b.line( h );
+                double* out_a = &buffer_a[ h * width ];
+                double* out_b = &buffer_b[ 2 * h * width ];
+                for ( uint32_t w=0; w<width; ++w )
+                {
+                    out_a[w] = static_cast<double>( line_a[w] );
+                    out_b[w] = out_b[w + width] = static_cast<double>( line_b[w] );
+                }
+            }
+
+            OutT output{ size_ };
+            const auto [min_x, max_x] = detail::lag_range( width, max_lag_ );
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag_ );
+            const double scale = size_.area();
+            for ( int32_t dy=min_y; dy<=max_y; ++dy )
+            {
+                const uint32_t shift_y = ( dy + height ) % height;
+                auto* out = output.line( ( dy + height/2 + height ) % height );
+                for ( int32_t dx=min_x; dx<=max_x; ++dx )
+                {
+                    const uint32_t shift_x = ( dx + width ) % width;
+                    double sum = 0;
+                    for ( uint32_t h=0; h<height; ++h )
+                        sum += detail::dot( &buffer_a[ h * width ],
+                                            &buffer_b[ 2 * ( ( h + shift_y ) % height ) * width + shift_x ],
+                                            width );
+
+                    out[ ( dx + width/2 + width ) % width ] = static_cast<ValueT>( scale * sum );
+                }
+            }
+
+            return output;
+        }
+
+        /// identical to cross_correlate; provided for interface
+        /// compatibility with FFT & PocketFFT
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename ValueT = arithmetic_t<typename ContainedT::value_t>,
+                   typename OutT = image<g<ValueT>>,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate_real( const ImageT<ContainedT>& a,
+                              const ImageT<ContainedT>& b ) const
+        {
+            return cross_correlate<ImageT, ContainedT, ValueT, OutT>( a, b );
+        }
+
+        /// cross-correlate \a a and \a b, normalizing the evaluated lags
+        /// to ZNCC (\sa zncc_normalization)
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate_zncc( const ImageT<ContainedT>& a,
+                              const ImageT<ContainedT>& b,
+                              const zncc_normalization& n ) const
+        {
+            if ( fft_ )
+                return fft_->cross_correlate_zncc<ImageT, ContainedT, OutT>( a, b, n );
+
+            OutT output{ cross_correlate<ImageT, ContainedT, double, OutT>( a, b ) };
+            const auto [width, height] = size_.components();
+            const auto [min_x, max_x] = detail::lag_range( width, max_lag_ );
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag_ );
+            for ( int32_t dy=min_y; dy<=max_y; ++dy )
+            {
+                auto* out = output.line( ( dy + height/2 + height ) % height );
+                for ( int32_t dx=min_x; dx<=max_x; ++dx )
+                {
+                    auto& v = out[ ( dx + width/2 + width ) % width ];
+                    v = n( v );
+                }
+            }
+
+            return output;
+        }
+    };
+
+}
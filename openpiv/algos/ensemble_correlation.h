@@ -0,0 +1,165 @@
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// local
+#include "algos/fft.h"
+#include "algos/fft_common.h"
+#include "algos/spectrum_cache.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/image_utils.h"
+#include "core/image_view.h"
+#include "core/parallel.h"
+#include "core/rect.h"
+#include "core/size.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    /// Ensemble correlation averages the correlation planes of each
+    /// interrogation area of a grid over many frame pairs, which
+    /// recovers a usable peak from sparsely seeded data such as
+    /// micro-PIV.
+    ///
+    /// As the inverse transform is linear the spectrum product
+    /// b_fft * conj(a_fft) is accumulated for each interrogation area
+    /// as pairs are added, and a single inverse transform per area is
+    /// performed when the correlation is requested. Frames are not
+    /// retained so memory use is one complex accumulator per
+    /// interrogation area, regardless of the number of pairs.
+    ///
+    /// \a FFTT is the transform used e.g. FFT or PocketFFT; all
+    /// interrogation areas must have the same size.
+    template < typename FFTT = FFT >
+    class EnsembleCorrelation
+    {
+        std::vector<core::rect> grid_;
+        FFTT fft_;
+        std::vector<cf_image> accumulators_;
+        size_t pair_count_ = 0;
+
+        static core::size window_size( const std::vector<core::rect>& grid )
+        {
+            if ( grid.empty() )
+                exception_builder<std::runtime_error>() << "grid must not be empty";
+
+            return grid.front().size();
+        }
+
+    public:
+        EnsembleCorrelation( std::vector<core::rect> grid )
+            : grid_( std::move(grid) )
+            , fft_( window_size( grid_ ) )
+        {
+            const auto s = window_size( grid_ );
+            for ( const auto& r : grid_ )
+                if ( r.size() != s )
+                    exception_builder<std::runtime_error>() << "interrogation areas must have the same size: " << r << ", " << s;
+
+            accumulators_.resize( grid_.size(), cf_image{ s } );
+        }
+
+        inline const std::vector<core::rect>& grid() const { return grid_; }
+
+        /// \returns the number of frame pairs accumulated
+        inline size_t pair_count() const { return pair_count_; }
+
+        /// accumulate the spectrum products of the frame pair \a a,
+        /// \a b for each interrogation area; areas are processed
+        /// concurrently
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        void add( const ImageT<ContainedT>& a, const ImageT<ContainedT>& b )
+        {
+            if ( a.size() != b.size() )
+                exception_builder<std::runtime_error>() << "image sizes are different: " << a.size() << ", " << b.size();
+
+            parallel_for_blocks(
+                grid_.size(),
+                [this, &a, &b]( size_t begin, size_t end )
+                {
+                    for ( size_t i=begin; i<end; ++i )
+                    {
+                        cf_image a_fft{ fft_.transform( create_image_view( a, grid_[i] ), direction::FORWARD ) };
+                        const cf_image& b_fft = fft_.transform( create_image_view( b, grid_[i] ), direction::FORWARD );
+                        accumulators_[i] = accumulators_[i] + b_fft * conj( a_fft );
+                    }
+                },
+                16 );
+
+            ++pair_count_;
+        }
+
+        /// as add, but the spectra of the interrogation areas of each
+        /// frame are taken from, or added to, \a cache using the frame
+        /// ids \a frame_a and \a frame_b; frames that appear in more
+        /// than one pair (e.g. A-B, B-C, ... in time-resolved sequences)
+        /// are then only transformed once
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        void add( const ImageT<ContainedT>& a, uint64_t frame_a,
+                  const ImageT<ContainedT>& b, uint64_t frame_b,
+                  spectrum_cache& cache )
+        {
+            if ( a.size() != b.size() )
+                exception_builder<std::runtime_error>() << "image sizes are different: " << a.size() << ", " << b.size();
+
+            parallel_for_blocks(
+                grid_.size(),
+                [this, &a, frame_a, &b, frame_b, &cache]( size_t begin, size_t end )
+                {
+                    for ( size_t i=begin; i<end; ++i )
+                    {
+                        auto spectrum = [this, &r = grid_[i]]( const auto& im ) {
+                                            return cf_image{ fft_.transform( create_image_view( im, r ), direction::FORWARD ) };
+                                        };
+                        const auto a_fft = cache.get( { frame_a, grid_[i] }, [&](){ return spectrum( a ); } );
+                        const auto b_fft = cache.get( { frame_b, grid_[i] }, [&](){ return spectrum( b ); } );
+                        accumulators_[i] = accumulators_[i] + *b_fft * conj( *a_fft );
+                    }
+                },
+                16 );
+
+            ++pair_count_;
+        }
+
+        /// \returns the correlation plane of the interrogation area at
+        /// \a index averaged over all pairs; the layout matches that
+        /// of FFT::cross_correlate
+        gf_image correlation( size_t index ) const
+        {
+            if ( pair_count_ == 0 )
+                exception_builder<std::runtime_error>() << "no frame pairs have been added";
+
+            gf_image output{ real( fft_.transform( accumulators_.at( index ), direction::REVERSE ) ) * g_f{ 1.0 / pair_count_ } };
+            swap_quadrants( output );
+
+            return output;
+        }
+
+        /// discard all accumulated pairs
+        void reset()
+        {
+            for ( auto& accumulator : accumulators_ )
+                fill( accumulator, c_f{} );
+            pair_count_ = 0;
+        }
+    };
+
+}
@@ -2,8 +2,10 @@
 
 // std
 #include <algorithm>
+#include <deque>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
@@ -16,6 +18,7 @@
 #include "core/image.h"
 #include "core/image_utils.h"
 #include "core/pixel_types.h"
+#include "core/split_complex_image.h"
 #include "core/util.h"
 
 namespace openpiv::algos {
@@ -42,8 +45,10 @@ namespace openpiv::algos {
             cf_image temp;
         };
 
-        /// helpers to allow TLS for intermediate storage
-        using storage_t = std::vector< std::tuple<FFT*, data_t> >;
+        /// helpers to allow TLS for intermediate storage; a deque so
+        /// that adding an entry for another instance on this thread
+        /// doesn't invalidate results already returned
+        using storage_t = std::deque< std::tuple<FFT*, data_t> >;
         storage_t& storage() const
         {
             thread_local static storage_t static_data;
@@ -99,7 +104,7 @@ namespace openpiv::algos {
 
             // copy data, converting to complex
             cache().output = input;
-            cache().temp.resize( input.size() );
+            cache().temp.resize( transpose( input.size() ) );
 
             // iterate over rows first
             for ( uint32_t h = 0; h < cache().output.height(); ++h )
@@ -118,6 +123,100 @@ namespace openpiv::algos {
             return cache().output;
         }
 
+        /// Perform a forward 2-D FFT of \a input zero-padded to size();
+        /// \a input is placed at the origin. The transform is input
+        /// pruned: rows that are entirely padding have a zero transform
+        /// so are skipped in the first pass.
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        const cf_image& transform_padded( const ImageT<ContainedT>& input ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( input.width() > size_.width() || input.height() > size_.height() )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is larger than expected: " << input.size() << ", " << size_;
+            }
+
+            auto& output = cache().output;
+            fill( output, c_f{} );
+            for ( uint32_t h = 0; h < input.height(); ++h )
+            {
+                c_f* out = output.line(h);
+                core::detail::convert_row( input.line(h), out, input.width() );
+
+                fft( out, output.width(), direction::FORWARD );
+            }
+
+            // columns: all are non-zero
+            transpose( output, cache().temp );
+            for ( uint32_t h = 0; h < cache().temp.height(); ++h )
+                fft( cache().temp.line(h), cache().temp.width(), direction::FORWARD );
+            transpose( cache().temp, output );
+
+            return output;
+        }
+
+        /// Perform a reverse 2-D FFT of \a input that is output pruned:
+        /// only rows within +/- \a max_lag of row 0 (wrapping) are
+        /// transformed in the final pass and all other rows of the
+        /// output are undefined.
+        const cf_image& transform_pruned( const cf_image& input, uint32_t max_lag ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( input.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is different from expected: " << input.size() << ", " << size_;
+            }
+
+            // columns first so that only the required rows need be done last
+            auto& output = cache().output;
+            transpose( input, cache().temp );
+            for ( uint32_t h = 0; h < cache().temp.height(); ++h )
+                fft( cache().temp.line(h), cache().temp.width(), direction::REVERSE );
+            transpose( cache().temp, output );
+
+            const auto height = output.height();
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag );
+            for ( int32_t dy = min_y; dy <= max_y; ++dy )
+                fft( output.line( ( dy + height ) % height ), output.width(), direction::REVERSE );
+
+            return output;
+        }
+
+        /// Perform 1-D FFTs of each column of \a input; line x of \a
+        /// output holds the transform of column x, so \a output has the
+        /// transposed size of \a input. The height of \a input must be
+        /// one of the dimensions of size().
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        void transform_columns( const ImageT<ContainedT>& input, cf_image& output, direction d = direction::FORWARD ) const
+        {
+            DECLARE_ENTRY_EXIT
+            const auto n = input.height();
+            if ( n != size_.width() && n != size_.height() )
+            {
+                exception_builder< std::runtime_error >()
+                    << "column length is not a transform dimension: " << n << ", " << size_;
+            }
+
+            output.resize( transpose( input.size() ) );
+            for ( uint32_t h = 0; h < n; ++h )
+            {
+                const ContainedT* in = input.line(h);
+                for ( uint32_t w = 0; w < input.width(); ++w )
+                    convert( in[w], output.line(w)[h] );
+            }
+
+            for ( uint32_t h = 0; h < output.height(); ++h )
+                fft( output.line(h), n, d );
+        }
+
         /// Perform a 2-D FFT of two real images; will produce two
         /// output images
         template < template <typename> class ImageT,
@@ -141,8 +240,8 @@ namespace openpiv::algos {
             }
 
             // copy data to (real, imag), converting to complex
-            cache().output = join_from_channels(a, b);
-            cache().temp.resize( cache().output.size() );
+            cache().output = join_from_channels<ImageT, typename ContainedT::value_t, cf_image>( a, b );
+            cache().temp.resize( transpose( cache().output.size() ) );
 
             // iterate over rows first
             for ( uint32_t h = 0; h < cache().output.height(); ++h )
@@ -187,7 +286,7 @@ namespace openpiv::algos {
 
         template < template <typename> class ImageT,
                    typename ContainedT,
-                   typename ValueT = typename ContainedT::value_t,
+                   typename ValueT = arithmetic_t<typename ContainedT::value_t>,
                    typename OutT = image<g<ValueT>>,
                    typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
                    >
@@ -207,7 +306,7 @@ namespace openpiv::algos {
 
         template < template <typename> class ImageT,
                    typename ContainedT,
-                   typename ValueT = typename ContainedT::value_t,
+                   typename ValueT = arithmetic_t<typename ContainedT::value_t>,
                    typename OutT = image<g<ValueT>>,
                    typename = typename std::enable_if_t<
                        is_imagetype_v<ImageT<ContainedT>> &&
@@ -226,6 +325,134 @@ namespace openpiv::algos {
             return output;
         }
 
+        /// cross-correlate from the forward transforms \a a_fft and
+        /// \a b_fft of the windows (e.g. from a spectrum_cache) rather
+        /// than the windows themselves; equivalent to cross_correlate
+        template < typename OutT = gf_image >
+        OutT
+        cross_correlate_spectra( const cf_image& a_fft,
+                                 const cf_image& b_fft ) const
+        {
+            if ( a_fft.size() != size_ || b_fft.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "spectrum size is different from expected: " << a_fft.size() << ", " << b_fft.size() << ", " << size_;
+            }
+
+            const cf_image product{ b_fft * conj( a_fft ) };
+            OutT output{ real( transform( product, direction::REVERSE ) ) };
+            swap_quadrants( output );
+
+            return output;
+        }
+
+        /// Perform a forward 2-D FFT, producing a split complex
+        /// spectrum; \sa cross_correlate_spectra
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        split_cf_image transform_split( const ImageT<ContainedT>& input ) const
+        {
+            return split_cf_image{ transform( input, direction::FORWARD ) };
+        }
+
+        /// cross-correlate from split complex forward transforms \a
+        /// a_fft and \a b_fft; the product of the spectra is formed
+        /// from the planes and interleaved as it is stored
+        template < typename OutT = gf_image >
+        OutT
+        cross_correlate_spectra( const split_cf_image& a_fft,
+                                 const split_cf_image& b_fft ) const
+        {
+            if ( a_fft.size() != size_ || b_fft.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "spectrum size is different from expected: " << a_fft.size() << ", " << b_fft.size() << ", " << size_;
+            }
+
+            cf_image product;
+            conj_multiply( a_fft, b_fft, product );
+            OutT output{ real( transform( product, direction::REVERSE ) ) };
+            swap_quadrants( output );
+
+            return output;
+        }
+
+        /// cross-correlate windows \a a and \a b zero-padded to size()
+        /// (e.g. 32x32 windows with a 64x64 FFT) so that the correlation
+        /// doesn't wrap around, evaluating only lags within +/- \a
+        /// max_lag using pruned transforms (\sa transform_padded, \sa
+        /// transform_pruned).
+        ///
+        /// The output has the size and layout of cross_correlate of the
+        /// windows i.e. zero displacement at the centre, and includes a
+        /// factor of the padded area from the unscaled inverse
+        /// transform; lags that are not evaluated are zero.
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate_padded( const ImageT<ContainedT>& a,
+                                const ImageT<ContainedT>& b,
+                                uint32_t max_lag = std::numeric_limits<uint32_t>::max() ) const
+        {
+            if ( a.size() != b.size() )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image sizes are different: " << a.size() << ", " << b.size();
+            }
+
+            const auto [width, height] = a.size().components();
+            const auto [min_x, max_x] = detail::lag_range( width, max_lag );
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag );
+
+            cf_image a_fft{ transform_padded( a ) };
+            const cf_image& b_fft = transform_padded( b );
+            a_fft = b_fft * conj( a_fft );
+            const cf_image& correlation = transform_pruned( a_fft, std::max( -min_y, max_y ) );
+
+            using value_t = typename OutT::pixel_t::value_t;
+            OutT output{ a.size() };
+            for ( int32_t dy = min_y; dy <= max_y; ++dy )
+            {
+                const c_f* in = correlation.line( ( dy + size_.height() ) % size_.height() );
+                auto* out = output.line( dy + height/2 );
+                for ( int32_t dx = min_x; dx <= max_x; ++dx )
+                    out[ dx + width/2 ] = static_cast<value_t>( in[ ( dx + size_.width() ) % size_.width() ].real );
+            }
+
+            return output;
+        }
+
+        /// cross-correlate \a a and \a b, normalizing to ZNCC (\sa
+        /// zncc_normalization) as the correlation plane is
+        /// materialized rather than in a separate pass
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        OutT
+        cross_correlate_zncc( const ImageT<ContainedT>& a,
+                              const ImageT<ContainedT>& b,
+                              const zncc_normalization& n ) const
+        {
+            cf_image a_fft{ transform( a, direction::FORWARD ) };
+            const cf_image& b_fft = transform( b, direction::FORWARD );
+
+            a_fft = b_fft * conj( a_fft );
+            OutT output{ ( real( transform( a_fft, direction::REVERSE ) ) - g_f{ n.offset } ) * g_f{ n.scale } };
+            swap_quadrants( output );
+
+            return output;
+        }
+
         template < template <typename> class ImageT,
                    typename ContainedT,
                    typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
@@ -1,8 +1,14 @@
 
 #pragma once
 
+// std
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
 // local
 #include "core/enum_helper.h"
+#include "core/size.h"
 
 namespace openpiv::algos {
 
@@ -16,4 +22,51 @@ namespace openpiv::algos {
             { direction::REVERSE, "reverse" }
         } )
 
+    namespace detail {
+
+        /// range of lags evaluated along an axis of length \a n when
+        /// lags are limited to +/- \a max_lag; zero displacement is at
+        /// n/2 in a correlation plane
+        inline std::tuple<int32_t, int32_t> lag_range( uint32_t n, uint32_t max_lag )
+        {
+            return { -static_cast<int32_t>( std::min( max_lag, n/2 ) ),
+                     static_cast<int32_t>( std::min( max_lag, n - 1 - n/2 ) ) };
+        }
+
+    }
+
+    /// maps the unnormalized correlation plane produced by
+    /// cross_correlate to zero-normalized cross-correlation (ZNCC)
+    /// i.e. values in [-1, 1] that do not depend on the brightness or
+    /// contrast of the windows.
+    ///
+    /// The correlation is circular so every shift sees all N pixels of
+    /// both windows; the whole plane is therefore normalized by a
+    /// single offset and scale derived from the window means and
+    /// standard deviations (e.g. from \sa window_statistics):
+    ///
+    /// zncc = ( c - N^2.mean_a.mean_b ) / ( N^2.stddev_a.stddev_b )
+    ///
+    /// where the extra factor of N is due to the unscaled inverse
+    /// transform. Windows without contrast have no defined ZNCC and
+    /// map to zero.
+    struct zncc_normalization
+    {
+        double offset = 0.0;
+        double scale = 1.0;
+
+        zncc_normalization() = default;
+        zncc_normalization( const core::size& window,
+                            double mean_a, double stddev_a,
+                            double mean_b, double stddev_b )
+        {
+            const double n = window.area();
+            const double denominator = n * n * stddev_a * stddev_b;
+            offset = n * n * mean_a * mean_b;
+            scale = denominator > 0.0 ? 1.0 / denominator : 0.0;
+        }
+
+        inline double operator()( double c ) const { return ( c - offset ) * scale; }
+    };
+
 }
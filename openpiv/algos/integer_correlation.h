@@ -0,0 +1,225 @@
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "algos/direct_correlation.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/pixel_types.h"
+#include "core/size.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    namespace detail {
+
+        /// \returns the dot product of \a a and \a b, each of length
+        /// \a n; products are accumulated in 32-bit lanes, each of which
+        /// receives up to n/4 products
+        inline int64_t dot( const int16_t* a, const int16_t* b, size_t n )
+        {
+            size_t i = 0;
+            int64_t result = 0;
+#if defined(__AVX2__)
+            __m256i acc = _mm256_setzero_si256();
+            for ( ; i + 16 <= n; i += 16 )
+            {
+                const __m256i va = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + i ) );
+                const __m256i vb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + i ) );
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+                acc = _mm256_dpwssd_epi32( acc, va, vb );
+#elif defined(__AVXVNNI__)
+                acc = _mm256_dpwssd_avx_epi32( acc, va, vb );
+#else
+                acc = _mm256_add_epi32( acc, _mm256_madd_epi16( va, vb ) );
+#endif
+            }
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), acc );
+            for ( const auto lane : lanes )
+                result += lane;
+#elif defined(__SSE2__)
+            __m128i acc = _mm_setzero_si128();
+            for ( ; i + 8 <= n; i += 8 )
+            {
+                const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + i ) );
+                const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + i ) );
+                acc = _mm_add_epi32( acc, _mm_madd_epi16( va, vb ) );
+            }
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), acc );
+            for ( const auto lane : lanes )
+                result += lane;
+#endif
+            for ( ; i<n; ++i )
+                result += static_cast<int32_t>( a[i] ) * b[i];
+
+            return result;
+        }
+
+    }
+
+    /// Spatial-domain correlation of 8 or 16-bit images using 16-bit
+    /// integer multiply-adds (pmaddwd, or vpdpwssd where VNNI is
+    /// available) with 32-bit accumulation. As with DirectCorrelation
+    /// only lags within +/- \a max_lag pixels of zero displacement are
+    /// evaluated and the output matches that of FFT::cross_correlate.
+    ///
+    /// Pixel values must fit in significant_bits so that the 32-bit
+    /// accumulators cannot overflow; images with a greater \a bit_depth
+    /// are shifted down before correlation and the output is rescaled,
+    /// losing the least significant bits. By default the bit depth is
+    /// that of the pixel type, e.g. 16 for g_16; a smaller depth may
+    /// be given for data known to use fewer bits, and pixels that
+    /// exceed it are reported.
+    ///
+    /// This class is thread-safe
+    class IntegerCorrelation
+    {
+        core::size size_;
+        uint32_t max_lag_;
+        uint8_t bit_depth_;
+
+        /// storage for intermediate data
+        struct data_t
+        {
+            std::vector<int16_t> a;
+            std::vector<int16_t> b;
+        };
+
+        data_t& cache() const
+        {
+            thread_local static data_t data;
+            return data;
+        }
+
+    public:
+        /// largest pixel bit depth that is correlated without loss
+        static constexpr uint8_t significant_bits = 12;
+
+        /// widest window for which 32-bit accumulation of a row of
+        /// significant_bits products cannot overflow
+        static constexpr uint32_t max_width = 512;
+
+        /// bit depth that selects the depth of the pixel type
+        static constexpr uint8_t pixel_depth = 0;
+
+        IntegerCorrelation( const core::size& size, uint32_t max_lag, uint8_t bit_depth = pixel_depth )
+            : size_(size)
+            , max_lag_(max_lag)
+            , bit_depth_(bit_depth)
+        {
+            if ( size_.area() == 0 )
+                exception_builder<std::runtime_error>() << "dimensions must be non-zero: " << size_;
+
+            if ( size_.width() > max_width )
+                exception_builder<std::runtime_error>() << "width must be at most " << max_width << ": " << size_;
+
+            if ( bit_depth > 16 )
+                exception_builder<std::runtime_error>() << "bit depth must be at most 16: " << (int)bit_depth;
+        }
+
+        inline const core::size& size() const { return size_; }
+        inline uint32_t max_lag() const { return max_lag_; }
+
+        /// \returns the bit depth, or pixel_depth
+        inline uint8_t bit_depth() const { return bit_depth_; }
+
+        /// \returns the number of least significant bits discarded
+        /// from each pixel value of type \ta ValueT
+        template < typename ValueT >
+        inline uint8_t shift() const
+        {
+            const uint8_t depth = bit_depth_ == pixel_depth ? 8 * sizeof(ValueT) : bit_depth_;
+            return depth > significant_bits ? depth - significant_bits : 0;
+        }
+
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT> &&
+                       std::is_integral_v<typename ContainedT::value_t> &&
+                       sizeof(typename ContainedT::value_t) <= 2
+                       >
+                   >
+        OutT
+        cross_correlate( const ImageT<ContainedT>& a,
+                         const ImageT<ContainedT>& b ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( a.size() != size_ || b.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is different from expected: " << a.size() << ", " << b.size() << ", " << size_;
+            }
+
+            const auto [width, height] = size_.components();
+            const uint8_t discarded = shift<typename ContainedT::value_t>();
+
+            // copy a, and b with each row repeated so that a circular
+            // shift of a row is contiguous
+            auto& [buffer_a, buffer_b] = cache();
+            uint32_t bits = 0;
+            buffer_a.resize( size_.area() );
+            buffer_b.resize( 2 * size_.area() );
+            for ( uint32_t h=0; h<height; ++h )
+            {
+                const ContainedT* line_a = a.line( h );
+                const ContainedT* line_b = b.line( h );
+                int16_t* out_a = &buffer_a[ h * width ];
+                int16_t* out_b = &buffer_b[ 2 * h * width ];
+                for ( uint32_t w=0; w<width; ++w )
+                {
+                    bits |= line_a[w].v | line_b[w].v;
+                    out_a[w] = static_cast<int16_t>( line_a[w].v >> discarded );
+                    out_b[w] = out_b[w + width] = static_cast<int16_t>( line_b[w].v >> discarded );
+                }
+            }
+
+            // values wider than an explicit bit depth would wrap or
+            // overflow the accumulators
+            if ( bit_depth_ != pixel_depth && bit_depth_ < 8 * sizeof(typename ContainedT::value_t) &&
+                 ( bits >> bit_depth_ ) != 0 )
+                exception_builder< std::runtime_error >()
+                    << "pixel values exceed bit depth of " << (int)bit_depth_ << ": " << bits;
+
+            using value_t = typename OutT::pixel_t::value_t;
+            OutT output{ size_ };
+            const auto [min_x, max_x] = detail::lag_range( width, max_lag_ );
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag_ );
+            const double scale = static_cast<double>( size_.area() ) * ( uint64_t{1} << ( 2 * discarded ) );
+            for ( int32_t dy=min_y; dy<=max_y; ++dy )
+            {
+                const uint32_t shift_y = ( dy + height ) % height;
+                auto* out = output.line( ( dy + height/2 + height ) % height );
+                for ( int32_t dx=min_x; dx<=max_x; ++dx )
+                {
+                    const uint32_t shift_x = ( dx + width ) % width;
+                    int64_t sum = 0;
+                    for ( uint32_t h=0; h<height; ++h )
+                        sum += detail::dot( &buffer_a[ h * width ],
+                                            &buffer_b[ 2 * ( ( h + shift_y ) % height ) * width + shift_x ],
+                                            width );
+
+                    out[ ( dx + width/2 + width ) % width ] = static_cast<value_t>( scale * sum );
+                }
+            }
+
+            return output;
+        }
+    };
+
+}
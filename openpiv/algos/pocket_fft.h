@@ -2,8 +2,10 @@
 
 // std
 #include <algorithm>
+#include <deque>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <thread>
 #include <tuple>
 #include <unordered_map>
@@ -43,8 +45,10 @@ namespace openpiv::algos {
             cf_image temp;
         };
 
-        /// helpers to allow TLS for intermediate storage
-        using storage_t = std::vector< std::tuple<PocketFFT*, data_t> >;
+        /// helpers to allow TLS for intermediate storage; a deque so
+        /// that adding an entry for another instance on this thread
+        /// doesn't invalidate results already returned
+        using storage_t = std::deque< std::tuple<PocketFFT*, data_t> >;
         storage_t& storage() const
         {
             thread_local static storage_t static_data;
@@ -102,17 +106,22 @@ namespace openpiv::algos {
             cache().temp = input;
             cache().output.resize( input.size() );
 
+            // strides respect the row pitch of each image
+            constexpr auto stride_lambda = [](auto& im) -> pfft::stride_t
+                {
+                    const auto [stride_x, stride_y] = im.stride();
+                    return {static_cast<long>(stride_x), static_cast<long>(stride_y)};
+                };
+
             const pfft::shape_t shape = {size_.width(), size_.height()};
-            const auto [stride_x, stride_y] = cache().temp.stride();
-            const pfft::stride_t stride = {static_cast<long>(stride_x), static_cast<long>(stride_y)};
 
             // can reinterpret core::complex to std::complex because core::complex is packed and
             // std::complex is also packed and makes guarantees about accessibility through array
             // access
             pfft::c2c<value_t>(
                 shape,
-                stride,
-                stride,                  // input and output strides should be the same
+                stride_lambda(cache().temp),
+                stride_lambda(cache().output),
                 { 0, 1 },                // axes
                 d == direction::FORWARD, // forward
                 reinterpret_cast<const std::complex<value_t>*>(cache().temp.data()),
@@ -122,6 +131,89 @@ namespace openpiv::algos {
             return cache().output;
         }
 
+        /// Perform a forward 2-D FFT of \a input zero-padded to size();
+        /// \a input is placed at the origin. The transform is input
+        /// pruned: rows that are entirely padding have a zero transform
+        /// so are skipped in the first pass.
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        const cf_image& transform_padded( const ImageT<ContainedT>& input ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( input.width() > size_.width() || input.height() > size_.height() )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is larger than expected: " << input.size() << ", " << size_;
+            }
+
+            using value_t = c_f::value_t;
+
+            auto& output = cache().output;
+            fill( output, c_f{} );
+            for ( uint32_t h = 0; h < input.height(); ++h )
+            {
+                const ContainedT* in = input.line(h);
+                c_f* out = output.line(h);
+                for ( uint32_t w = 0; w < input.width(); ++w )
+                    convert( in[w], out[w] );
+            }
+
+            const auto [stride_x, stride_y] = output.stride();
+            const pfft::stride_t stride = {static_cast<long>(stride_x), static_cast<long>(stride_y)};
+            auto* data = reinterpret_cast<std::complex<value_t>*>(output.data());
+
+            // rows containing input, then all columns
+            pfft::c2c<value_t>( { size_.width(), input.height() }, stride, stride, { 0 }, true, data, data, 1.0 );
+            pfft::c2c<value_t>( { size_.width(), size_.height() }, stride, stride, { 1 }, true, data, data, 1.0 );
+
+            return output;
+        }
+
+        /// Perform a reverse 2-D FFT of \a input that is output pruned:
+        /// only rows within +/- \a max_lag of row 0 (wrapping) are
+        /// transformed in the final pass and all other rows of the
+        /// output are undefined.
+        const cf_image& transform_pruned( const cf_image& input, uint32_t max_lag ) const
+        {
+            DECLARE_ENTRY_EXIT
+            if ( input.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image size is different from expected: " << input.size() << ", " << size_;
+            }
+
+            using value_t = c_f::value_t;
+
+            auto& output = cache().output;
+            const auto [stride_x, stride_y] = output.stride();
+            const pfft::stride_t stride = {static_cast<long>(stride_x), static_cast<long>(stride_y)};
+
+            // columns first so that only the required rows need be done last
+            const auto [in_stride_x, in_stride_y] = input.stride();
+            const pfft::stride_t in_stride = {static_cast<long>(in_stride_x), static_cast<long>(in_stride_y)};
+            pfft::c2c<value_t>( { size_.width(), size_.height() }, in_stride, stride, { 1 }, false,
+                                reinterpret_cast<const std::complex<value_t>*>(input.data()),
+                                reinterpret_cast<std::complex<value_t>*>(output.data()),
+                                1.0 );
+
+            // required rows are two contiguous blocks: [0, max_y] and [height + min_y, height)
+            const auto height = size_.height();
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag );
+            auto rows = [&]( uint32_t first, uint32_t count )
+                        {
+                            if ( count == 0 )
+                                return;
+                            auto* data = reinterpret_cast<std::complex<value_t>*>(output.line(first));
+                            pfft::c2c<value_t>( { size_.width(), count }, stride, stride, { 0 }, false, data, data, 1.0 );
+                        };
+            rows( 0, max_y + 1 );
+            rows( height + min_y, -min_y );
+
+            return output;
+        }
+
         /// Perform a 2-D FFT of two real images; will produce two
         /// output images
         template < template <typename> class ImageT,
@@ -274,6 +366,94 @@ namespace openpiv::algos {
             return output;
         }
 
+        /// cross-correlate from the forward transforms \a a_fft and
+        /// \a b_fft of the windows (e.g. from a spectrum_cache) rather
+        /// than the windows themselves; equivalent to cross_correlate
+        template < typename OutT = gf_image >
+        OutT
+        cross_correlate_spectra( const cf_image& a_fft,
+                                 const cf_image& b_fft ) const
+        {
+            if ( a_fft.size() != size_ || b_fft.size() != size_ )
+            {
+                exception_builder< std::runtime_error >()
+                    << "spectrum size is different from expected: " << a_fft.size() << ", " << b_fft.size() << ", " << size_;
+            }
+
+            const cf_image product{ b_fft * conj( a_fft ) };
+            OutT output{ real( transform( product, direction::REVERSE ) ) };
+            swap_quadrants( output );
+
+            return output;
+        }
+
+        /// cross-correlate windows \a a and \a b zero-padded to size()
+        /// so that the correlation doesn't wrap around, evaluating only
+        /// lags within +/- \a max_lag; \sa FFT::cross_correlate_padded
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        OutT
+        cross_correlate_padded( const ImageT<ContainedT>& a,
+                                const ImageT<ContainedT>& b,
+                                uint32_t max_lag = std::numeric_limits<uint32_t>::max() ) const
+        {
+            if ( a.size() != b.size() )
+            {
+                exception_builder< std::runtime_error >()
+                    << "image sizes are different: " << a.size() << ", " << b.size();
+            }
+
+            const auto [width, height] = a.size().components();
+            const auto [min_x, max_x] = detail::lag_range( width, max_lag );
+            const auto [min_y, max_y] = detail::lag_range( height, max_lag );
+
+            cf_image a_fft{ transform_padded( a ) };
+            const cf_image& b_fft = transform_padded( b );
+            a_fft = b_fft * conj( a_fft );
+            const cf_image& correlation = transform_pruned( a_fft, std::max( -min_y, max_y ) );
+
+            using value_t = typename OutT::pixel_t::value_t;
+            OutT output{ a.size() };
+            for ( int32_t dy = min_y; dy <= max_y; ++dy )
+            {
+                const c_f* in = correlation.line( ( dy + size_.height() ) % size_.height() );
+                auto* out = output.line( dy + height/2 );
+                for ( int32_t dx = min_x; dx <= max_x; ++dx )
+                    out[ dx + width/2 ] = static_cast<value_t>( in[ ( dx + size_.width() ) % size_.width() ].real );
+            }
+
+            return output;
+        }
+
+        /// cross-correlate \a a and \a b, normalizing to ZNCC (\sa
+        /// zncc_normalization) as the correlation plane is
+        /// materialized rather than in a separate pass
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OutT = gf_image,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        OutT
+        cross_correlate_zncc( const ImageT<ContainedT>& a,
+                              const ImageT<ContainedT>& b,
+                              const zncc_normalization& n ) const
+        {
+            cf_image a_fft{ transform( a, direction::FORWARD ) };
+            cf_image b_fft{ transform( b, direction::FORWARD ) };
+
+            a_fft = b_fft * conj( a_fft );
+            OutT output{ ( real( transform( a_fft, direction::REVERSE ) ) - g_f{ n.offset } ) * g_f{ n.scale } };
+            swap_quadrants( output );
+
+            return output;
+        }
+
         template < template <typename> class ImageT,
                    typename ContainedT,
                    typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
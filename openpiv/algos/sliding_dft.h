@@ -0,0 +1,189 @@
+
+#pragma once
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// local
+#include "algos/fft.h"
+#include "algos/fft_common.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/image_view.h"
+#include "core/rect.h"
+#include "core/size.h"
+#include "core/util.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    /// Computes the forward transforms of a row of overlapping windows
+    /// incrementally; at high overlap neighbouring windows share most
+    /// of their pixels so each spectrum is derived from the previous
+    /// one using sliding-DFT updates rather than transformed from
+    /// scratch.
+    ///
+    /// start() transforms each image column of the band of rows
+    /// covered by the window once; moving the window right by one
+    /// pixel then removes the spectrum of the column leaving the window,
+    /// adds that of the column entering it and applies a phase shift:
+    ///
+    /// X'[u,v] = exp(2.pi.i.u/W) ( X[u,v] - C_x0[v] + C_x0+W[v] )
+    ///
+    /// so the cost of each window grows with the step size rather than
+    /// the window area. The spectrum is periodically recomputed from
+    /// the (exact) column spectra, every \a refresh_interval updates,
+    /// to bound numerical drift; this is also done when a step is so
+    /// large that it would be cheaper.
+    ///
+    /// The spectra match those of FFT::transform of each window.
+    ///
+    /// This class is not thread-safe; use an instance per thread
+    class SlidingDFT
+    {
+        const core::size size_;
+        const uint32_t refresh_interval_;
+        /// log2 of the (power of two) width
+        const uint32_t log2_width_;
+        FFT fft_;
+
+        /// exp(-2.pi.i.j/W) for j in [0, W)
+        std::vector<c_f> twiddle_;
+
+        /// line x holds the transform of image column x over the band
+        cf_image columns_;
+        cf_image spectrum_;
+        cf_image temp_;
+        core::rect window_;
+        uint32_t updates_ = 0;
+
+        static constexpr uint32_t log2( uint32_t v )
+        {
+            uint32_t result = 0;
+            while ( v >>= 1 )
+                ++result;
+            return result;
+        }
+
+        /// recompute the spectrum of the current window from the
+        /// column spectra
+        void refresh()
+        {
+            const core::rect block{ { 0, window_.left() }, transpose( size_ ) };
+            fft_.transform_columns( create_image_view( columns_, block ), spectrum_ );
+            updates_ = 0;
+        }
+
+    public:
+        SlidingDFT( const core::size& size, uint32_t refresh_interval = 16 )
+            : size_( size )
+            , refresh_interval_( refresh_interval )
+            , log2_width_( log2( size.width() ) )
+            , fft_( size )
+            , twiddle_( size.width() )
+        {
+            if ( refresh_interval_ == 0 )
+                exception_builder<std::runtime_error>() << "refresh interval must be at least 1";
+
+            const auto n = size_.width();
+            for ( uint32_t j = 0; j < n; ++j )
+            {
+                const double theta = -2.0 * M_PI * j / n;
+                twiddle_[j] = c_f{ std::cos( theta ), std::sin( theta ) };
+            }
+        }
+
+        inline const core::size& size() const { return size_; }
+        inline uint32_t refresh_interval() const { return refresh_interval_; }
+
+        /// \returns the current window
+        inline const core::rect& window() const { return window_; }
+
+        /// \returns the spectrum of the current window
+        inline const cf_image& spectrum() const { return spectrum_; }
+
+        /// start a row of windows at \a window of \a image; the column
+        /// spectra of the band of rows covered by \a window are
+        /// computed and retained, so \a image need not outlive this call
+        /// \returns the spectrum of \a window
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        const cf_image& start( const ImageT<ContainedT>& image, const core::rect& window )
+        {
+            if ( window.size() != size_ )
+                exception_builder<std::runtime_error>() << "window size is different from expected: " << window.size() << ", " << size_;
+            if ( !image.rect().contains( window ) )
+                exception_builder<std::runtime_error>() << "window is outside of image: " << window << ", " << image.rect();
+
+            const core::rect band{ { 0, window.bottom() }, { image.width(), size_.height() } };
+            fft_.transform_columns( create_image_view( image, band ), columns_ );
+
+            window_ = window;
+            refresh();
+
+            return spectrum_;
+        }
+
+        /// move the window \a step pixels to the right
+        /// \returns the spectrum of the new window
+        const cf_image& advance( uint32_t step )
+        {
+            const auto [width, height] = size_.components();
+            if ( static_cast<uint64_t>( window_.right() ) + step > columns_.height() )
+                exception_builder<std::runtime_error>() << "window is outside of image: " << window_ << " + " << step;
+
+            const auto x0 = window_.left();
+            window_ = core::rect{ { x0 + static_cast<int32_t>(step), window_.bottom() }, size_ };
+
+            // each column moved costs a pass over the spectrum; beyond
+            // ~log2(W) columns a refresh is cheaper
+            if ( step == 0 )
+                return spectrum_;
+            if ( ++updates_ >= refresh_interval_ || step >= width || step > log2_width_ )
+            {
+                refresh();
+                return spectrum_;
+            }
+
+            // X[u,v] += sum_k w^uk ( C_x0+W+k[v] - C_x0+k[v] ); the
+            // width is a power of two so indices wrap with a mask
+            const uint32_t mask = width - 1;
+            temp_.resize( { height, 1 } );
+            c_f* delta = temp_.data();
+            for ( uint32_t k = 0; k < step; ++k )
+            {
+                const c_f* in = columns_.line( x0 + width + k );
+                const c_f* out = columns_.line( x0 + k );
+                for ( uint32_t v = 0; v < height; ++v )
+                    delta[v] = in[v] - out[v];
+
+                for ( uint32_t v = 0; v < height; ++v )
+                {
+                    c_f* row = spectrum_.line( v );
+                    for ( uint32_t u = 0, j = 0; u < width; ++u, j = ( j + k ) & mask )
+                        row[u] = row[u] + twiddle_[j] * delta[v];
+                }
+            }
+
+            // X'[u,v] = w^-us X[u,v]
+            for ( uint32_t v = 0; v < height; ++v )
+            {
+                c_f* row = spectrum_.line( v );
+                for ( uint32_t u = 0, j = 0; u < width; ++u, j = ( j - step ) & mask )
+                    row[u] = row[u] * twiddle_[j];
+            }
+
+            return spectrum_;
+        }
+    };
+
+}
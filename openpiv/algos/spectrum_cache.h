@@ -0,0 +1,190 @@
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// local
+#include "core/image.h"
+#include "core/rect.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    /// identifies the spectrum of a window of a frame
+    struct spectrum_key
+    {
+        uint64_t frame = 0;      ///< caller assigned frame id e.g. index in a sequence
+        core::rect window;       ///< window within the frame
+        uint64_t settings = 0;   ///< identifies preprocessing applied before the transform
+
+        inline bool operator==( const spectrum_key& rhs ) const
+        {
+            return frame == rhs.frame && window == rhs.window && settings == rhs.settings;
+        }
+    };
+
+    struct spectrum_key_hash
+    {
+        size_t operator()( const spectrum_key& k ) const
+        {
+            auto combine = []( size_t seed, size_t v ) {
+                return seed ^ ( v + 0x9e3779b97f4a7c15ull + ( seed << 6 ) + ( seed >> 2 ) );
+            };
+
+            size_t result = std::hash<uint64_t>{}( k.frame );
+            result = combine( result, std::hash<uint64_t>{}( k.settings ) );
+            result = combine( result, std::hash<int32_t>{}( k.window.left() ) );
+            result = combine( result, std::hash<int32_t>{}( k.window.bottom() ) );
+            result = combine( result, std::hash<uint32_t>{}( k.window.width() ) );
+            result = combine( result, std::hash<uint32_t>{}( k.window.height() ) );
+            return result;
+        }
+    };
+
+    /// A cache of forward transforms of windows so that frames used in
+    /// more than one pair (e.g. A-B, B-C, ... in time-resolved
+    /// sequences) are only transformed once.
+    ///
+    /// Entries are evicted in least recently used order once the total
+    /// size of the cached spectra exceeds \a capacity bytes. Spectra are
+    /// shared so an entry that is evicted remains valid for any caller
+    /// still holding it.
+    ///
+    /// This class is thread-safe
+    class spectrum_cache
+    {
+    public:
+        using spectrum_ptr = std::shared_ptr<const cf_image>;
+
+        explicit spectrum_cache( size_t capacity )
+            : capacity_(capacity)
+        {}
+
+        /// \returns the cached spectrum for \a key or nullptr
+        spectrum_ptr find( const spectrum_key& key )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            auto it = index_.find( key );
+            if ( it == index_.end() )
+            {
+                ++misses_;
+                return {};
+            }
+
+            ++hits_;
+            entries_.splice( entries_.begin(), entries_, it->second );
+            return it->second->spectrum;
+        }
+
+        /// add \a spectrum for \a key, replacing any existing entry
+        spectrum_ptr insert( const spectrum_key& key, cf_image spectrum )
+        {
+            auto result = std::make_shared<const cf_image>( std::move(spectrum) );
+            const size_t bytes = result->pixel_count() * sizeof(c_f);
+
+            std::lock_guard<std::mutex> lock( mutex_ );
+            if ( auto it = index_.find( key ); it != index_.end() )
+            {
+                memory_ -= it->second->bytes;
+                entries_.erase( it->second );
+                index_.erase( it );
+            }
+
+            entries_.push_front( { key, result, bytes } );
+            index_[key] = entries_.begin();
+            memory_ += bytes;
+            evict();
+
+            return result;
+        }
+
+        /// \returns the cached spectrum for \a key, calling \a compute to
+        /// produce and cache it if not present:
+        ///
+        /// cf_image compute()
+        ///
+        /// \a compute is called without the cache locked so concurrent
+        /// callers may compute the same spectrum; the last one is kept
+        template < typename F >
+        spectrum_ptr get( const spectrum_key& key, F&& compute )
+        {
+            if ( auto result = find( key ) )
+                return result;
+
+            return insert( key, compute() );
+        }
+
+        /// remove all entries
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            entries_.clear();
+            index_.clear();
+            memory_ = 0;
+        }
+
+        inline size_t capacity() const { return capacity_; }
+
+        /// \returns the number of cached spectra
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            return entries_.size();
+        }
+
+        /// \returns the total size in bytes of the cached spectra
+        size_t memory() const
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            return memory_;
+        }
+
+        size_t hits() const
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            return hits_;
+        }
+
+        size_t misses() const
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            return misses_;
+        }
+
+    private:
+        struct entry_t
+        {
+            spectrum_key key;
+            spectrum_ptr spectrum;
+            size_t bytes;
+        };
+        using entries_t = std::list<entry_t>;
+
+        void evict()
+        {
+            while ( memory_ > capacity_ && !entries_.empty() )
+            {
+                const auto& last = entries_.back();
+                memory_ -= last.bytes;
+                index_.erase( last.key );
+                entries_.pop_back();
+            }
+        }
+
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        entries_t entries_;
+        std::unordered_map<spectrum_key, entries_t::iterator, spectrum_key_hash> index_;
+        size_t memory_ = 0;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+    };
+
+}
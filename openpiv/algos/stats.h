@@ -2,16 +2,345 @@
 #pragma once
 
 // std
+#include <cmath>
+#include <cstdint>
+#include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // local
 #include "core/image.h"
+#include "core/image_expression.h"
 #include "core/image_type_traits.h"
+#include "core/parallel.h"
+#include "core/pixel_types.h"
 
 namespace openpiv::algos {
 
     using namespace core;
 
+    namespace detail {
+
+        /// pixel type of an image or image expression
+        template < typename E, typename = void >
+        struct reduction_pixel
+        {
+            using type = std::decay_t< decltype( std::declval<const E&>().row( 0 )[0] ) >;
+        };
+
+        template < typename E >
+        struct reduction_pixel< E, std::enable_if_t< is_imagetype_v<E> > >
+        {
+            using type = typename E::pixel_t;
+        };
+
+        template < typename E >
+        using reduction_pixel_t = typename reduction_pixel<E>::type;
+
+        /// type in which pixels are summed: integers exactly, others in
+        /// double precision
+        template < typename P >
+        struct accumulator
+        {
+            using type = double;
+        };
+
+        template < typename T >
+        struct accumulator< g<T> >
+        {
+            using type = std::conditional_t< std::is_integral_v<T>, int64_t, double >;
+        };
+
+        template < typename T >
+        struct accumulator< complex<T> >
+        {
+            using type = complex<double>;
+        };
+
+        template < typename P >
+        using accumulator_t = typename accumulator<P>::type;
+
+        template < typename AccT, typename P >
+        inline AccT accumulate_value( const P& p )
+        {
+            if constexpr ( std::is_same_v< AccT, complex<double> > )
+                return { static_cast<double>( p.real ), static_cast<double>( p.imag ) };
+            else
+                return static_cast<AccT>( p );
+        }
+
+        template < typename P >
+        inline double magnitude_sqr( const P& p )
+        {
+            if constexpr ( is_complex_mono_pixeltype_v<P> )
+                return static_cast<double>( p.real ) * p.real + static_cast<double>( p.imag ) * p.imag;
+            else
+                return static_cast<double>( p ) * static_cast<double>( p );
+        }
+
+        /// sum \a f over \a n pixels in independent lanes, which keeps
+        /// the loop vectorizable without reassociating a single
+        /// floating point sum, and combine the lanes pairwise
+        template < typename AccT, typename P, typename F >
+        inline AccT lane_sum( const P* p, uint32_t n, F f )
+        {
+            constexpr uint32_t lanes = 8;
+            AccT acc[lanes]{};
+            uint32_t x = 0;
+            for ( ; x + lanes <= n; x += lanes )
+                for ( uint32_t k = 0; k < lanes; ++k )
+                    acc[k] += f( p[x + k] );
+            for ( ; x < n; ++x )
+                acc[x % lanes] += f( p[x] );
+
+            return ( ( acc[0] + acc[1] ) + ( acc[2] + acc[3] ) ) +
+                   ( ( acc[4] + acc[5] ) + ( acc[6] + acc[7] ) );
+        }
+
+        /// \returns the pixel of \a n preferred by \a better, starting
+        /// from \a initial, using independent lanes as for lane_sum;
+        /// greyscale pixels are compared by value, which vectorizes
+        template < typename P, typename F >
+        inline P lane_select( const P* p, uint32_t n, P initial, F better )
+        {
+            const auto value = []( const P& v )
+                               {
+                                   if constexpr ( is_real_mono_pixeltype_v<P> )
+                                       return v.v;
+                                   else
+                                       return v;
+                               };
+
+            constexpr uint32_t lanes = 8;
+            decltype( value( initial ) ) acc[lanes];
+            for ( uint32_t k = 0; k < lanes; ++k )
+                acc[k] = value( initial );
+
+            uint32_t x = 0;
+            for ( ; x + lanes <= n; x += lanes )
+                for ( uint32_t k = 0; k < lanes; ++k )
+                    acc[k] = better( value( p[x + k] ), acc[k] ) ? value( p[x + k] ) : acc[k];
+            for ( ; x < n; ++x )
+                acc[0] = better( value( p[x] ), acc[0] ) ? value( p[x] ) : acc[0];
+
+            for ( uint32_t k = 1; k < lanes; ++k )
+                acc[0] = better( acc[k], acc[0] ) ? acc[k] : acc[0];
+            return P( acc[0] );
+        }
+
+        /// \returns row \a h of \a e as contiguous pixels; rows of
+        /// expressions are evaluated into \a buffer
+        template < typename E, typename P >
+        inline const P* reduction_row( const E& e, uint32_t h, std::vector<P>& buffer )
+        {
+            if constexpr ( is_imagetype_v<E> )
+                return e.line( h );
+            else
+            {
+                const auto row = e.row( h );
+                const uint32_t w = e.size().width();
+                buffer.resize( w );
+                for ( uint32_t x = 0; x < w; ++x )
+                    buffer[x] = row[x];
+                return buffer.data();
+            }
+        }
+
+    }
+
+    /// reductions for use with reduce(); each is default constructed
+    /// empty, adds rows of pixels with add(), combines with another
+    /// partial reduction of the same kind with merge() and gives its
+    /// value with result()
+
+    /// sum of pixels; integer pixels are summed exactly, others in
+    /// double precision
+    template < typename P >
+    struct sum_reduction
+    {
+        using result_t = detail::accumulator_t<P>;
+
+        inline void add( const P* row, uint32_t n )
+        {
+            value += detail::lane_sum<result_t>( row, n, []( const P& p ){ return detail::accumulate_value<result_t>( p ); } );
+        }
+        inline void merge( const sum_reduction& rhs ) { value += rhs.value; }
+        inline result_t result() const { return value; }
+
+        result_t value{};
+    };
+
+    /// sum of squared magnitudes of pixels
+    template < typename P >
+    struct sum_sqr_reduction
+    {
+        using result_t = double;
+
+        inline void add( const P* row, uint32_t n )
+        {
+            value += detail::lane_sum<double>( row, n, []( const P& p ){ return detail::magnitude_sqr( p ); } );
+        }
+        inline void merge( const sum_sqr_reduction& rhs ) { value += rhs.value; }
+        inline result_t result() const { return value; }
+
+        double value = 0;
+    };
+
+    /// smallest pixel; complex pixels are ordered by magnitude
+    template < typename P >
+    struct min_reduction
+    {
+        using result_t = P;
+
+        inline void add( const P* row, uint32_t n )
+        {
+            if ( n == 0 )
+                return;
+
+            value = detail::lane_select( row, n, any ? value : row[0],
+                                         []( const auto& a, const auto& b ){ return a < b; } );
+            any = true;
+        }
+        inline void merge( const min_reduction& rhs )
+        {
+            if ( rhs.any && ( !any || rhs.value < value ) )
+                *this = rhs;
+        }
+        inline result_t result() const { return value; }
+
+        P value{};
+        bool any = false;
+    };
+
+    /// largest pixel; complex pixels are ordered by magnitude
+    template < typename P >
+    struct max_reduction
+    {
+        using result_t = P;
+
+        inline void add( const P* row, uint32_t n )
+        {
+            if ( n == 0 )
+                return;
+
+            value = detail::lane_select( row, n, any ? value : row[0],
+                                         []( const auto& a, const auto& b ){ return a > b; } );
+            any = true;
+        }
+        inline void merge( const max_reduction& rhs )
+        {
+            if ( rhs.any && ( !any || rhs.value > value ) )
+                *this = rhs;
+        }
+        inline result_t result() const { return value; }
+
+        P value{};
+        bool any = false;
+    };
+
+    /// compute several \a Reductions of an image, image view or image
+    /// expression in a single pass without materializing it e.g.
+    ///
+    ///   auto [ lo, hi, total ] = reduce< min_reduction, max_reduction, sum_reduction >( a - b );
+    ///
+    /// Each row of an expression is evaluated once into a small
+    /// buffer and consumed by all reductions while in cache. Partial
+    /// results of rows are merged pairwise, which bounds rounding
+    /// error growth of sums by the logarithm of the height; large
+    /// images are split by rows across threads.
+    ///
+    /// \returns a tuple of the results of \a Reductions
+    template < template<typename> class... Reductions,
+               typename E,
+               typename = typename std::enable_if_t< is_imagetype_v<E> || is_imageexpression_v<E> >
+               >
+    std::tuple< typename Reductions< detail::reduction_pixel_t<E> >::result_t... >
+    reduce( const E& e )
+    {
+        using P = detail::reduction_pixel_t<E>;
+        using state_t = std::tuple< Reductions<P>... >;
+
+        const core::size s = e.size();
+        const auto merge = []( state_t& lhs, const state_t& rhs )
+                           {
+                               std::apply( [&rhs]( auto&... l ){
+                                   std::apply( [&l...]( const auto&... r ){ ( l.merge( r ), ... ); }, rhs );
+                               }, lhs );
+                           };
+
+        // reduce rows [first, last) pairwise
+        const auto reduce_rows = [&e, &s, &merge]( const auto& self, uint32_t first, uint32_t last, std::vector<P>& buffer ) -> state_t
+                                 {
+                                     if ( last - first == 1 )
+                                     {
+                                         state_t result;
+                                         const P* row = detail::reduction_row( e, first, buffer );
+                                         std::apply( [row, &s]( auto&... r ){ ( r.add( row, s.width() ), ... ); }, result );
+                                         return result;
+                                     }
+
+                                     const uint32_t mid = first + ( last - first ) / 2;
+                                     state_t result = self( self, first, mid, buffer );
+                                     merge( result, self( self, mid, last, buffer ) );
+                                     return result;
+                                 };
+
+        state_t result;
+        if ( s.area() == 0 )
+            return std::apply( []( const auto&... r ){ return std::make_tuple( r.result()... ); }, result );
+
+        std::vector< std::optional<state_t> > blocks( s.height() );
+        parallel_for_blocks(
+            s.height(),
+            [&]( size_t first, size_t last )
+            {
+                std::vector<P> buffer;
+                blocks[first] = reduce_rows( reduce_rows, first, last, buffer );
+            },
+            std::max<size_t>( 1, image<P>::parallel_pixels / s.width() ) );
+
+        for ( const auto& block : blocks )
+            if ( block )
+                merge( result, *block );
+
+        return std::apply( []( const auto&... r ){ return std::make_tuple( r.result()... ); }, result );
+    }
+
+    /// \returns the sum of the pixels of an image or image expression
+    template < typename E,
+               typename = typename std::enable_if_t< is_imagetype_v<E> || is_imageexpression_v<E> > >
+    auto image_sum( const E& e )
+    {
+        return std::get<0>( reduce< sum_reduction >( e ) );
+    }
+
+    /// \returns the mean of the pixels of an image or image expression
+    template < typename E,
+               typename = typename std::enable_if_t< is_imagetype_v<E> || is_imageexpression_v<E> > >
+    double image_mean( const E& e )
+    {
+        return static_cast<double>( image_sum( e ) ) / e.size().area();
+    }
+
+    /// \returns the smallest and largest pixels of an image or image
+    /// expression
+    template < typename E,
+               typename = typename std::enable_if_t< is_imagetype_v<E> || is_imageexpression_v<E> > >
+    auto image_min_max( const E& e )
+    {
+        return reduce< min_reduction, max_reduction >( e );
+    }
+
+    /// \returns the L2 norm of an image or image expression
+    template < typename E,
+               typename = typename std::enable_if_t< is_imagetype_v<E> || is_imageexpression_v<E> > >
+    double image_norm( const E& e )
+    {
+        return std::sqrt( std::get<0>( reduce< sum_sqr_reduction >( e ) ) );
+    }
+
     template < template<typename> class ImageT,
                typename ContainedT,
                typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
@@ -19,18 +348,7 @@ namespace openpiv::algos {
     std::tuple< ContainedT, ContainedT >
     find_image_range( const ImageT<ContainedT>& im )
     {
-        ContainedT min, max;
-        auto p = std::cbegin( im );
-        auto e = std::cend( im );
-        min = max = *p++;
-        while ( p != e )
-        {
-            min = *p < min ? *p : min;
-            max = *p > max ? *p : max;
-            ++p;
-        }
-
-        return std::make_tuple( min, max );
+        return image_min_max( im );
     }
 
 }
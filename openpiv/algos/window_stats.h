@@ -0,0 +1,127 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+// local
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/rect.h"
+#include "core/summed_area_table.h"
+
+namespace openpiv::algos {
+
+    using namespace core;
+
+    /// intensity statistics of a single interrogation window
+    struct window_stats
+    {
+        double mean = 0.0;
+        double stddev = 0.0;
+        uint32_t particles = 0;
+    };
+
+    /// thresholds used to decide whether a window has enough signal
+    /// to be worth correlating; a threshold of zero is disabled
+    struct signal_thresholds
+    {
+        double minimum_mean = 0.0;
+        double minimum_stddev = 0.0;
+        uint32_t minimum_particles = 0;
+
+        inline bool enabled() const
+        {
+            return minimum_mean > 0.0 || minimum_stddev > 0.0 || minimum_particles > 0;
+        }
+    };
+
+    /// \returns true if \a s falls below any of \a t
+    inline bool is_low_signal( const window_stats& s, const signal_thresholds& t )
+    {
+        return
+            s.mean < t.minimum_mean ||
+            s.stddev < t.minimum_stddev ||
+            s.particles < t.minimum_particles;
+    }
+
+    /// pre-computes summed-area tables (\sa summed_area_table) of a
+    /// frame's intensity, squared intensity and particle locations so
+    /// that the statistics of any window can be found in O(1), prior
+    /// to correlation.
+    ///
+    /// A particle is a pixel that is a local maximum (as per
+    /// \sa find_peaks) and that is brighter than a threshold; if no
+    /// threshold is supplied then the frame mean plus one standard
+    /// deviation is used.
+    class window_statistics
+    {
+    public:
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       is_imagetype_v<ImageT<ContainedT>> &&
+                       is_real_mono_pixeltype_v<ContainedT>
+                       >
+                   >
+        explicit window_statistics( const ImageT<ContainedT>& im,
+                                    std::optional<double> particle_threshold = {} )
+            : size_( im.size() )
+            , sum_( im )
+            , sum_sqr_( im, []( const ContainedT& v ){ const double d = v; return d*d; } )
+        {
+            const auto width = im.width();
+            const auto height = im.height();
+
+            const auto frame = rect::from_size( size_ );
+            const double threshold = particle_threshold.value_or(
+                sum_.mean( frame ) + std::sqrt( variance( sum_, sum_sqr_, frame ) ) );
+
+            // particle mask; edge pixels are never counted
+            g8_image mask{ size_ };
+            for ( uint32_t h=1; h+1<height; ++h )
+            {
+                const ContainedT* above = im.line( h - 1 );
+                const ContainedT* line = im.line( h );
+                const ContainedT* below = im.line( h + 1 );
+                g_8* out = mask.line( h );
+                for ( uint32_t w=1; w+1<width; ++w )
+                {
+                    const auto v = line[w];
+                    if ( v > threshold &&
+                         line[w-1] < v && line[w+1] < v && above[w] < v && below[w] < v )
+                        out[w] = 1;
+                }
+            }
+            particles_ = summed_area_table<int64_t>{ mask };
+        }
+
+        /// \returns the statistics of the window \a r; \a r must lie
+        /// within the frame
+        window_stats operator()( const core::rect& r ) const
+        {
+            window_stats result;
+            const double sum = sum_.sum( r );
+            if ( r.area() == 0 )
+                return result;
+
+            result.mean = sum / r.area();
+            result.stddev = std::sqrt( variance( sum_, sum_sqr_, r ) );
+            result.particles = static_cast<uint32_t>( particles_.sum( r ) );
+
+            return result;
+        }
+
+        inline const core::size& size() const { return size_; }
+
+    private:
+        core::size size_;
+        summed_area_table<double> sum_;
+        summed_area_table<double> sum_sqr_;
+        summed_area_table<int64_t> particles_;
+    };
+
+}
@@ -0,0 +1,333 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// openpiv
+#include "core/exception_builder.h"
+#include "core/grid.h"
+#include "core/rect.h"
+#include "core/size.h"
+#include "core/vector.h"
+
+namespace openpiv::core {
+
+    /// quadtree of interrogation areas; the grid starts out as a
+    /// centred cartesian grid (\sa generate_cartesian_grid) and each
+    /// of those interrogation areas forms the root of a quadtree.
+    ///
+    /// Leaves may be subdivided into four equally sized quadrants
+    /// until \a minimum_size is reached, so that resolution is only
+    /// spent where it adds information e.g. in a thin shear layer.
+    ///
+    /// Each node may store a result of type \ta ValueT; nodes are
+    /// never removed, so indices remain valid as the grid is refined.
+    template <typename ValueT>
+    class adaptive_grid
+    {
+    public:
+        using value_t = ValueT;
+        using index_t = size_t;
+        static constexpr index_t npos = std::numeric_limits<index_t>::max();
+
+        struct node
+        {
+            core::rect r;
+            uint8_t level = 0;
+            index_t parent = npos;
+            std::array<index_t, 4> children{ npos, npos, npos, npos };
+            std::optional<ValueT> value;
+
+            inline bool is_leaf() const { return children[0] == npos; }
+        };
+
+        adaptive_grid( const core::size& image_size,
+                       const core::size& interrogation_size,
+                       double percentage_offset,
+                       const core::size& minimum_size )
+            : image_rect_( rect::from_size( image_size ) )
+            , bin_size_( interrogation_size )
+            , minimum_size_( minimum_size )
+        {
+            if ( minimum_size_.area() == 0 )
+                exception_builder<std::runtime_error>() << "minimum size must be non-zero";
+
+            for ( const auto& r : generate_cartesian_grid( image_size, interrogation_size, percentage_offset ) )
+            {
+                node root;
+                root.r = r;
+                nodes_.push_back( std::move(root) );
+            }
+            root_count_ = nodes_.size();
+
+            // bin the roots to allow quick spatial lookup
+            bins_x_ = (image_size.width()  + bin_size_.width()  - 1) / bin_size_.width();
+            bins_y_ = (image_size.height() + bin_size_.height() - 1) / bin_size_.height();
+            bins_.resize( bins_x_ * bins_y_ );
+            for ( index_t i=0; i<root_count_; ++i )
+                for_each_bin( nodes_[i].r, [this, i]( auto& bin ){ bin.push_back( i ); } );
+        }
+
+        /// node accessors
+        inline const node& operator[]( index_t i ) const { return nodes_.at(i); }
+        inline node& operator[]( index_t i ) { return nodes_.at(i); }
+        inline const std::vector<node>& nodes() const { return nodes_; }
+        inline index_t size() const { return nodes_.size(); }
+        inline index_t root_count() const { return root_count_; }
+        inline const core::size& minimum_size() const { return minimum_size_; }
+
+        /// \returns the indices of all current leaves
+        std::vector<index_t> leaves() const
+        {
+            std::vector<index_t> result;
+            for ( index_t i=0; i<nodes_.size(); ++i )
+                if ( nodes_[i].is_leaf() )
+                    result.push_back( i );
+
+            return result;
+        }
+
+        /// \returns the rectangles of nodes with indices \a indices
+        std::vector<core::rect> rects( const std::vector<index_t>& indices ) const
+        {
+            std::vector<core::rect> result;
+            result.reserve( indices.size() );
+            for ( const auto& i : indices )
+                result.push_back( nodes_.at(i).r );
+
+            return result;
+        }
+
+        /// \returns true if node \a i is a leaf and its quadrants would
+        /// not be smaller than minimum_size()
+        bool can_subdivide( index_t i ) const
+        {
+            const auto& n = nodes_.at(i);
+            return
+                n.is_leaf() &&
+                n.r.width()/2  >= minimum_size_.width() &&
+                n.r.height()/2 >= minimum_size_.height();
+        }
+
+        /// split leaf \a i into four quadrants, ordered bottom-left,
+        /// bottom-right, top-left, top-right; \returns the indices of
+        /// the new nodes
+        std::array<index_t, 4> subdivide( index_t i )
+        {
+            if ( !can_subdivide( i ) )
+                exception_builder<std::runtime_error>()
+                    << "unable to subdivide node " << i << " (" << nodes_.at(i).r << ")";
+
+            const auto parent_rect = nodes_[i].r;
+            const auto level = nodes_[i].level + 1;
+            const core::size s{ parent_rect.width()/2, parent_rect.height()/2 };
+            const auto bl = parent_rect.bottomLeft();
+
+            std::array<index_t, 4> result;
+            for ( uint8_t q=0; q<4; ++q )
+            {
+                const rect::point_t origin{ bl[0] + (q % 2) * s.width(), bl[1] + (q / 2) * s.height() };
+
+                node child;
+                child.r = rect{ origin, s };
+                child.level = level;
+                child.parent = i;
+                result[q] = nodes_.size();
+                nodes_.push_back( std::move(child) );
+            }
+            nodes_[i].children = result;
+
+            return result;
+        }
+
+        /// subdivide all leaves for which \a p returns true; \a p has
+        /// the form:
+        ///
+        /// bool p( const adaptive_grid&, index_t )
+        ///
+        /// and all leaves are tested prior to any subdivision taking
+        /// place. Leaves that are already at the minimum size are left
+        /// untouched.
+        ///
+        /// \returns the indices of the newly created leaves
+        template < typename PredicateT,
+                   typename = std::enable_if_t<std::is_invocable_r_v<bool, PredicateT, const adaptive_grid&, index_t>> >
+        std::vector<index_t> refine( PredicateT p )
+        {
+            std::vector<index_t> to_split;
+            for ( const auto& i : leaves() )
+                if ( can_subdivide(i) && p( static_cast<const adaptive_grid&>(*this), i ) )
+                    to_split.push_back( i );
+
+            std::vector<index_t> result;
+            result.reserve( 4*to_split.size() );
+            for ( const auto& i : to_split )
+                for ( const auto& child : subdivide( i ) )
+                    result.push_back( child );
+
+            return result;
+        }
+
+        /// \returns leaves other than \a i that touch or overlap node \a i
+        std::vector<index_t> neighbours( index_t i ) const
+        {
+            const auto search = nodes_.at(i).r.dilate( 1 );
+            std::vector<index_t> roots;
+            for_each_bin( search,
+                          [&roots]( const auto& bin ){
+                              roots.insert( std::end(roots), std::begin(bin), std::end(bin) );
+                          } );
+            std::sort( std::begin(roots), std::end(roots) );
+            roots.erase( std::unique( std::begin(roots), std::end(roots) ), std::end(roots) );
+
+            std::vector<index_t> result;
+            std::vector<index_t> pending{ std::move(roots) };
+            while ( !pending.empty() )
+            {
+                const auto j = pending.back();
+                pending.pop_back();
+
+                const auto& n = nodes_[j];
+                if ( !n.r.intersects( search ) )
+                    continue;
+
+                if ( n.is_leaf() )
+                {
+                    if ( j != i )
+                        result.push_back( j );
+                }
+                else
+                    pending.insert( std::end(pending), std::begin(n.children), std::end(n.children) );
+            }
+
+            std::sort( std::begin(result), std::end(result) );
+            return result;
+        }
+
+    private:
+        /// call \a f with each of \a bins (bins_, const or not) that
+        /// \a r overlaps
+        template <typename BinsT, typename F>
+        void for_each_bin( BinsT& bins, const core::rect& r, F f ) const
+        {
+            const auto clipped = clip( r );
+            if ( !clipped )
+                return;
+
+            for ( uint32_t y=clipped->bottom() / bin_size_.height(); y<=(clipped->top() - 1) / bin_size_.height(); ++y )
+                for ( uint32_t x=clipped->left() / bin_size_.width(); x<=(clipped->right() - 1) / bin_size_.width(); ++x )
+                    f( bins[ y*bins_x_ + x ] );
+        }
+
+        template <typename F>
+        void for_each_bin( const core::rect& r, F f )
+        {
+            for_each_bin( bins_, r, f );
+        }
+
+        template <typename F>
+        void for_each_bin( const core::rect& r, F f ) const
+        {
+            for_each_bin( bins_, r, f );
+        }
+
+        std::optional<core::rect> clip( const core::rect& r ) const
+        {
+            if ( !r.intersects( image_rect_ ) )
+                return {};
+
+            const auto l = std::max( r.left(), image_rect_.left() );
+            const auto b = std::max( r.bottom(), image_rect_.bottom() );
+            const auto t = std::min( r.top(), image_rect_.top() );
+            const auto rt = std::min( r.right(), image_rect_.right() );
+
+            return core::rect{ {l, b}, { static_cast<uint32_t>(rt - l), static_cast<uint32_t>(t - b) } };
+        }
+
+        core::rect image_rect_;
+        core::size bin_size_;
+        core::size minimum_size_;
+        std::vector<node> nodes_;
+        index_t root_count_ = 0;
+        uint32_t bins_x_ = 0;
+        uint32_t bins_y_ = 0;
+        std::vector<std::vector<index_t>> bins_;
+    };
+
+
+    /// thresholds used by \sa refine_by_quality
+    struct refinement_criteria
+    {
+        /// leaves with a peak ratio (highest to next highest
+        /// correlation peak) below this value are refined
+        double minimum_peak_ratio = 1.2;
+
+        /// leaves whose displacement differs from any neighbour by
+        /// more than this (pixels of displacement per pixel of
+        /// separation) are refined
+        double maximum_gradient = 0.1;
+    };
+
+    /// refine an adaptive grid where correlation quality is poor or
+    /// where the displacement gradient is high; \a displacement and
+    /// \a peak_ratio extract the relevant data from a stored value:
+    ///
+    /// vector2<double> displacement( const ValueT& )
+    /// double peak_ratio( const ValueT& )
+    ///
+    /// leaves without a stored value are neither refined nor used
+    /// as neighbours.
+    ///
+    /// \returns the indices of the newly created leaves
+    template < typename ValueT,
+               typename DisplacementF,
+               typename PeakRatioF >
+    std::vector<size_t> refine_by_quality( adaptive_grid<ValueT>& grid,
+                                           const refinement_criteria& criteria,
+                                           DisplacementF displacement,
+                                           PeakRatioF peak_ratio )
+    {
+        using grid_t = adaptive_grid<ValueT>;
+        auto centre = []( const core::rect& r ) -> std::array<double, 2> {
+            return { r.left() + r.width()/2.0, r.bottom() + r.height()/2.0 };
+        };
+
+        return grid.refine(
+            [&]( const grid_t& g, typename grid_t::index_t i ) -> bool
+            {
+                const auto& n = g[i];
+                if ( !n.value )
+                    return false;
+
+                if ( peak_ratio( *n.value ) < criteria.minimum_peak_ratio )
+                    return true;
+
+                const auto v = displacement( *n.value );
+                const auto c = centre( n.r );
+                for ( const auto& j : g.neighbours( i ) )
+                {
+                    const auto& m = g[j];
+                    if ( !m.value )
+                        continue;
+
+                    const auto dv = displacement( *m.value ) - v;
+                    const auto cm = centre( m.r );
+                    const double distance = std::hypot( cm[0] - c[0], cm[1] - c[1] );
+                    if ( distance > 0 &&
+                         std::hypot( dv[0], dv[1] ) / distance > criteria.maximum_gradient )
+                        return true;
+                }
+
+                return false;
+            } );
+    }
+
+} // end of namespace
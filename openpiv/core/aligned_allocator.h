@@ -0,0 +1,89 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+// local
+#include "core/image_memory.h"
+
+namespace openpiv::core {
+
+    /// allocator returning storage aligned to \ta Alignment bytes
+    /// e.g. to a cache line or the widest SIMD register, obtained from
+    /// a polymorphic memory resource; a default constructed allocator
+    /// uses default_image_resource() (\sa image_pool_resource()).
+    ///
+    /// As for std::pmr::polymorphic_allocator the resource does not
+    /// travel on assignment, so an image keeps the resource it was
+    /// created with, and copies are made with the default resource.
+    template < typename T, size_t Alignment = 64 >
+    struct aligned_allocator
+    {
+        static_assert( Alignment >= alignof(T) && ( Alignment & ( Alignment - 1 ) ) == 0,
+                       "alignment must be a power of two of at least alignof(T)" );
+
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+        static constexpr size_t alignment = Alignment;
+
+        template < typename U >
+        struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+        aligned_allocator() noexcept
+            : resource_( default_image_resource() )
+        {}
+
+        aligned_allocator( std::pmr::memory_resource* resource ) noexcept
+            : resource_( resource ? resource : default_image_resource() )
+        {}
+
+        template < typename U >
+        aligned_allocator( const aligned_allocator<U, Alignment>& other ) noexcept
+            : resource_( other.resource() )
+        {}
+
+        aligned_allocator select_on_container_copy_construction() const
+        {
+            return {};
+        }
+
+        T* allocate( size_t n )
+        {
+            if ( n > std::numeric_limits<size_t>::max() / sizeof(T) )
+                throw std::bad_array_new_length();
+
+            return static_cast<T*>( resource_->allocate( n * sizeof(T), Alignment ) );
+        }
+
+        void deallocate( T* p, size_t n ) noexcept
+        {
+            resource_->deallocate( p, n * sizeof(T), Alignment );
+        }
+
+        /// \returns the resource from which storage is obtained
+        inline std::pmr::memory_resource* resource() const { return resource_; }
+
+        template < typename U >
+        bool operator==( const aligned_allocator<U, Alignment>& rhs ) const noexcept
+        {
+            return resource_ == rhs.resource() || resource_->is_equal( *rhs.resource() );
+        }
+
+        template < typename U >
+        bool operator!=( const aligned_allocator<U, Alignment>& rhs ) const noexcept
+        {
+            return !( *this == rhs );
+        }
+
+    private:
+        std::pmr::memory_resource* resource_;
+    };
+
+}
@@ -0,0 +1,191 @@
+
+#pragma once
+
+// std
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "core/exception_builder.h"
+
+namespace openpiv::core::detail {
+
+    /// row kernels for the separable filters in image_utils; all work
+    /// on single precision rows in place, using \a buffer (of at
+    /// least n + 2 * radius values per row) as scratch, and treat
+    /// pixels beyond the ends of a row as repeating the end pixels
+
+    /// copy \a n values of \a row to \a buffer offset by \a r and
+    /// repeat the end values r times either side
+    inline void pad_row( const float* row, size_t n, size_t r, float* buffer )
+    {
+        for ( size_t i=0; i<r; ++i )
+        {
+            buffer[i] = row[0];
+            buffer[r + n + i] = row[n - 1];
+        }
+        for ( size_t i=0; i<n; ++i )
+            buffer[r + i] = row[i];
+    }
+
+    /// out[x] = sum_i k[i] * in[x + i] for x in [0, n); \a in holds
+    /// n + taps - 1 values
+    inline void correlate_row( const float* in, float* out, size_t n, const float* k, size_t taps )
+    {
+        size_t x = 0;
+#if defined(__AVX__)
+        for ( ; x + 16 <= n; x += 16 )
+        {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            for ( size_t i=0; i<taps; ++i )
+            {
+                const __m256 ki = _mm256_set1_ps( k[i] );
+#if defined(__FMA__)
+                acc0 = _mm256_fmadd_ps( ki, _mm256_loadu_ps( in + x + i ), acc0 );
+                acc1 = _mm256_fmadd_ps( ki, _mm256_loadu_ps( in + x + i + 8 ), acc1 );
+#else
+                acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( ki, _mm256_loadu_ps( in + x + i ) ) );
+                acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( ki, _mm256_loadu_ps( in + x + i + 8 ) ) );
+#endif
+            }
+            _mm256_storeu_ps( out + x, acc0 );
+            _mm256_storeu_ps( out + x + 8, acc1 );
+        }
+#elif defined(__SSE2__)
+        for ( ; x + 8 <= n; x += 8 )
+        {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            for ( size_t i=0; i<taps; ++i )
+            {
+                const __m128 ki = _mm_set1_ps( k[i] );
+                acc0 = _mm_add_ps( acc0, _mm_mul_ps( ki, _mm_loadu_ps( in + x + i ) ) );
+                acc1 = _mm_add_ps( acc1, _mm_mul_ps( ki, _mm_loadu_ps( in + x + i + 4 ) ) );
+            }
+            _mm_storeu_ps( out + x, acc0 );
+            _mm_storeu_ps( out + x + 4, acc1 );
+        }
+#endif
+        for ( ; x < n; ++x )
+        {
+            float acc = 0;
+            for ( size_t i=0; i<taps; ++i )
+                acc += k[i] * in[x + i];
+            out[x] = acc;
+        }
+    }
+
+    /// filter \a row with \a taps coefficients \a k centred on each
+    /// pixel (i.e. correlate; convolution reverses \a k first)
+    inline void filter_row( float* row, size_t n, const float* k, size_t taps, float* buffer )
+    {
+        const size_t r = taps / 2;
+        pad_row( row, n, r, buffer );
+        correlate_row( buffer, row, n, k, taps );
+    }
+
+    /// mean of the 2 * \a r + 1 pixels centred on each pixel of \a L
+    /// \a rows; running sums, so the cost doesn't depend on \a r. The
+    /// rows are processed together so that their sums are independent
+    /// and overlap; \a buffer holds L padded rows
+    template < size_t L >
+    inline void box_rows( float* const* rows, size_t n, size_t r, float* buffer )
+    {
+        const size_t padded = n + 2 * r;
+        for ( size_t l=0; l<L; ++l )
+            pad_row( rows[l], n, r, buffer + l * padded );
+
+        const double scale = 1.0 / ( 2 * r + 1 );
+        double sum[L] = {};
+        for ( size_t l=0; l<L; ++l )
+            for ( size_t i=0; i<2*r; ++i )
+                sum[l] += buffer[l * padded + i];
+
+        for ( size_t x=0; x<n; ++x )
+        {
+            for ( size_t l=0; l<L; ++l )
+            {
+                const float* in = buffer + l * padded;
+                sum[l] += in[x + 2*r];
+                rows[l][x] = static_cast<float>( sum[l] * scale );
+                sum[l] -= in[x];
+            }
+        }
+    }
+
+    /// coefficients of the recursive approximation to a Gaussian of
+    /// I.T. Young and L.J. van Vliet, "Recursive implementation of the
+    /// Gaussian filter", Signal Processing 44 (1995) 139-151
+    struct recursive_gaussian_coefficients
+    {
+        double B = 1;
+        double b1 = 0;
+        double b2 = 0;
+        double b3 = 0;
+
+        /// coefficients for a Gaussian of standard deviation \a sigma,
+        /// which must be at least 0.5
+        explicit recursive_gaussian_coefficients( double sigma )
+        {
+            if ( !( sigma >= 0.5 ) )
+                exception_builder<std::invalid_argument>() << "recursive Gaussian requires sigma >= 0.5: " << sigma;
+
+            const double q = sigma >= 2.5 ?
+                0.98711 * sigma - 0.96330 :
+                3.97156 - 4.14554 * std::sqrt( 1 - 0.26891 * sigma );
+            const double q2 = q * q;
+            const double q3 = q2 * q;
+            const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+
+            b1 = ( 2.44413 * q + 2.85619 * q2 + 1.26661 * q3 ) / b0;
+            b2 = -( 1.4281 * q2 + 1.26661 * q3 ) / b0;
+            b3 = 0.422205 * q3 / b0;
+            B = 1 - ( b1 + b2 + b3 );
+        }
+    };
+
+    /// recursive Gaussian of \a L \a rows: a causal then an
+    /// anti-causal third order filter, each started from the steady
+    /// state of the repeated end pixel; the cost doesn't depend on
+    /// sigma. As for box_rows, the rows are processed together to
+    /// overlap their dependency chains
+    template < size_t L >
+    inline void recursive_gaussian_rows( float* const* rows, size_t n, const recursive_gaussian_coefficients& c )
+    {
+        if ( n == 0 )
+            return;
+
+        double w1[L], w2[L], w3[L];
+        for ( size_t l=0; l<L; ++l )
+            w1[l] = w2[l] = w3[l] = rows[l][0];
+        for ( size_t x=0; x<n; ++x )
+        {
+            for ( size_t l=0; l<L; ++l )
+            {
+                const double w = c.B * rows[l][x] + c.b1 * w1[l] + c.b2 * w2[l] + c.b3 * w3[l];
+                w3[l] = w2[l]; w2[l] = w1[l]; w1[l] = w;
+                rows[l][x] = static_cast<float>( w );
+            }
+        }
+
+        for ( size_t l=0; l<L; ++l )
+            w1[l] = w2[l] = w3[l] = rows[l][n - 1];
+        for ( size_t x=n; x-- > 0; )
+        {
+            for ( size_t l=0; l<L; ++l )
+            {
+                const double w = c.B * rows[l][x] + c.b1 * w1[l] + c.b2 * w2[l] + c.b3 * w3[l];
+                w3[l] = w2[l]; w2[l] = w1[l]; w1[l] = w;
+                rows[l][x] = static_cast<float>( w );
+            }
+        }
+    }
+
+}
@@ -0,0 +1,178 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace openpiv::core::detail {
+
+    /// kernels for 2x downsampling with the separable binomial filter
+    /// [1 3 3 1] / 8, which is centred between each pair of input
+    /// pixels and attenuates frequencies that would alias; an output
+    /// pixel x is centred on input 2x + 0.5.
+    ///
+    /// The vertical pass combines four input rows into an unscaled
+    /// row sum, written to \a sum + 1 so that the horizontal pass can
+    /// read one value before the start of the row; the horizontal
+    /// pass scales by 1/64. Single and double precision rows are
+    /// vectorized with AVX(2) or SSE2, with a scalar tail.
+
+    /// \a sum[1 + x] = r0[x] + 3 ( r1[x] + r2[x] ) + r3[x] for x in
+    /// [0, n), then repeat the end values into \a sum[0] and \a
+    /// sum[n + 1, n + 1 + tail)
+    template < typename V >
+    inline void downsample_columns( const V* r0, const V* r1, const V* r2, const V* r3,
+                                    V* sum, size_t n, size_t tail )
+    {
+        size_t x = 0;
+#if defined(__SSE2__)
+        if constexpr ( std::is_same_v<V, float> )
+        {
+#if defined(__AVX__)
+            const __m256 three = _mm256_set1_ps( 3.0f );
+            for ( ; x + 8 <= n; x += 8 )
+            {
+                const __m256 inner = _mm256_add_ps( _mm256_loadu_ps( r1 + x ), _mm256_loadu_ps( r2 + x ) );
+                const __m256 outer = _mm256_add_ps( _mm256_loadu_ps( r0 + x ), _mm256_loadu_ps( r3 + x ) );
+                _mm256_storeu_ps( sum + 1 + x, _mm256_add_ps( outer, _mm256_mul_ps( three, inner ) ) );
+            }
+#else
+            const __m128 three = _mm_set1_ps( 3.0f );
+            for ( ; x + 4 <= n; x += 4 )
+            {
+                const __m128 inner = _mm_add_ps( _mm_loadu_ps( r1 + x ), _mm_loadu_ps( r2 + x ) );
+                const __m128 outer = _mm_add_ps( _mm_loadu_ps( r0 + x ), _mm_loadu_ps( r3 + x ) );
+                _mm_storeu_ps( sum + 1 + x, _mm_add_ps( outer, _mm_mul_ps( three, inner ) ) );
+            }
+#endif
+        }
+        else if constexpr ( std::is_same_v<V, double> )
+        {
+#if defined(__AVX__)
+            const __m256d three = _mm256_set1_pd( 3.0 );
+            for ( ; x + 4 <= n; x += 4 )
+            {
+                const __m256d inner = _mm256_add_pd( _mm256_loadu_pd( r1 + x ), _mm256_loadu_pd( r2 + x ) );
+                const __m256d outer = _mm256_add_pd( _mm256_loadu_pd( r0 + x ), _mm256_loadu_pd( r3 + x ) );
+                _mm256_storeu_pd( sum + 1 + x, _mm256_add_pd( outer, _mm256_mul_pd( three, inner ) ) );
+            }
+#else
+            const __m128d three = _mm_set1_pd( 3.0 );
+            for ( ; x + 2 <= n; x += 2 )
+            {
+                const __m128d inner = _mm_add_pd( _mm_loadu_pd( r1 + x ), _mm_loadu_pd( r2 + x ) );
+                const __m128d outer = _mm_add_pd( _mm_loadu_pd( r0 + x ), _mm_loadu_pd( r3 + x ) );
+                _mm_storeu_pd( sum + 1 + x, _mm_add_pd( outer, _mm_mul_pd( three, inner ) ) );
+            }
+#endif
+        }
+#endif
+        for ( ; x < n; ++x )
+            sum[1 + x] = r0[x] + V{3} * ( r1[x] + r2[x] ) + r3[x];
+
+        sum[0] = sum[1];
+        for ( size_t i = 0; i < tail; ++i )
+            sum[n + 1 + i] = sum[n];
+    }
+
+    /// out[x] = ( sum[2x] + 3 ( sum[2x + 1] + sum[2x + 2] ) + sum[2x + 3] ) / 64
+    /// for x in [0, n); \a sum holds at least 2n + 4 values
+    template < typename V >
+    inline void downsample_row( const V* sum, V* out, size_t n )
+    {
+        size_t x = 0;
+#if defined(__SSE2__)
+        if constexpr ( std::is_same_v<V, float> )
+        {
+            // split 2 * lanes consecutive values into even and odd lanes
+#if defined(__AVX2__)
+            const auto split = []( const float* p, __m256& even, __m256& odd )
+                               {
+                                   const __m256 a = _mm256_loadu_ps( p );
+                                   const __m256 b = _mm256_loadu_ps( p + 8 );
+                                   even = _mm256_castpd_ps( _mm256_permute4x64_pd(
+                                       _mm256_castps_pd( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) ), 0xd8 ) );
+                                   odd = _mm256_castpd_ps( _mm256_permute4x64_pd(
+                                       _mm256_castps_pd( _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ), 0xd8 ) );
+                               };
+            const __m256 three = _mm256_set1_ps( 3.0f );
+            const __m256 scale = _mm256_set1_ps( 1.0f / 64 );
+            for ( ; x + 8 <= n; x += 8 )
+            {
+                __m256 e0, o0, e2, o2;
+                split( sum + 2*x, e0, o0 );
+                split( sum + 2*x + 2, e2, o2 );
+                const __m256 v = _mm256_add_ps( _mm256_add_ps( e0, o2 ), _mm256_mul_ps( three, _mm256_add_ps( o0, e2 ) ) );
+                _mm256_storeu_ps( out + x, _mm256_mul_ps( v, scale ) );
+            }
+#else
+            const auto split = []( const float* p, __m128& even, __m128& odd )
+                               {
+                                   const __m128 a = _mm_loadu_ps( p );
+                                   const __m128 b = _mm_loadu_ps( p + 4 );
+                                   even = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+                                   odd = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+                               };
+            const __m128 three = _mm_set1_ps( 3.0f );
+            const __m128 scale = _mm_set1_ps( 1.0f / 64 );
+            for ( ; x + 4 <= n; x += 4 )
+            {
+                __m128 e0, o0, e2, o2;
+                split( sum + 2*x, e0, o0 );
+                split( sum + 2*x + 2, e2, o2 );
+                const __m128 v = _mm_add_ps( _mm_add_ps( e0, o2 ), _mm_mul_ps( three, _mm_add_ps( o0, e2 ) ) );
+                _mm_storeu_ps( out + x, _mm_mul_ps( v, scale ) );
+            }
+#endif
+        }
+        else if constexpr ( std::is_same_v<V, double> )
+        {
+#if defined(__AVX2__)
+            const auto split = []( const double* p, __m256d& even, __m256d& odd )
+                               {
+                                   const __m256d a = _mm256_loadu_pd( p );
+                                   const __m256d b = _mm256_loadu_pd( p + 4 );
+                                   even = _mm256_permute4x64_pd( _mm256_unpacklo_pd( a, b ), 0xd8 );
+                                   odd = _mm256_permute4x64_pd( _mm256_unpackhi_pd( a, b ), 0xd8 );
+                               };
+            const __m256d three = _mm256_set1_pd( 3.0 );
+            const __m256d scale = _mm256_set1_pd( 1.0 / 64 );
+            for ( ; x + 4 <= n; x += 4 )
+            {
+                __m256d e0, o0, e2, o2;
+                split( sum + 2*x, e0, o0 );
+                split( sum + 2*x + 2, e2, o2 );
+                const __m256d v = _mm256_add_pd( _mm256_add_pd( e0, o2 ), _mm256_mul_pd( three, _mm256_add_pd( o0, e2 ) ) );
+                _mm256_storeu_pd( out + x, _mm256_mul_pd( v, scale ) );
+            }
+#else
+            const auto split = []( const double* p, __m128d& even, __m128d& odd )
+                               {
+                                   const __m128d a = _mm_loadu_pd( p );
+                                   const __m128d b = _mm_loadu_pd( p + 2 );
+                                   even = _mm_unpacklo_pd( a, b );
+                                   odd = _mm_unpackhi_pd( a, b );
+                               };
+            const __m128d three = _mm_set1_pd( 3.0 );
+            const __m128d scale = _mm_set1_pd( 1.0 / 64 );
+            for ( ; x + 2 <= n; x += 2 )
+            {
+                __m128d e0, o0, e2, o2;
+                split( sum + 2*x, e0, o0 );
+                split( sum + 2*x + 2, e2, o2 );
+                const __m128d v = _mm_add_pd( _mm_add_pd( e0, o2 ), _mm_mul_pd( three, _mm_add_pd( o0, e2 ) ) );
+                _mm_storeu_pd( out + x, _mm_mul_pd( v, scale ) );
+            }
+#endif
+        }
+#endif
+        for ( ; x < n; ++x )
+            out[x] = ( sum[2*x] + V{3} * ( sum[2*x + 1] + sum[2*x + 2] ) + sum[2*x + 3] ) * ( V{1} / 64 );
+    }
+
+}
@@ -0,0 +1,109 @@
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace openpiv::core::detail {
+
+    inline uint32_t float_bits( float f )
+    {
+        uint32_t result;
+        std::memcpy( &result, &f, sizeof(result) );
+        return result;
+    }
+
+    inline float bits_float( uint32_t u )
+    {
+        float result;
+        std::memcpy( &result, &u, sizeof(result) );
+        return result;
+    }
+
+    /// \returns the IEEE 754 binary16 nearest to \a f, rounding ties
+    /// to even; values too large for binary16 become infinity
+    inline uint16_t float_to_half_bits( float f )
+    {
+#if defined(__F16C__)
+        return static_cast<uint16_t>( _cvtss_sh( f, _MM_FROUND_TO_NEAREST_INT ) );
+#else
+        uint32_t u = float_bits( f );
+        const uint32_t sign = u & 0x80000000u;
+        u ^= sign;
+
+        uint32_t result;
+        if ( u >= ( 127u + 16 ) << 23 )
+        {
+            // infinity or NaN
+            result = u > 0x7f800000u ? 0x7e00 : 0x7c00;
+        }
+        else if ( u < 113u << 23 )
+        {
+            // subnormal or zero: adding a magic value aligns the
+            // mantissa bits at the bottom of the float and the float
+            // addition does the rounding
+            constexpr uint32_t magic = ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23;
+            result = float_bits( bits_float( u ) + bits_float( magic ) ) - magic;
+        }
+        else
+        {
+            // rebias the exponent and round the mantissa to nearest even
+            const uint32_t odd = ( u >> 13 ) & 1;
+            u += ( uint32_t( 15 - 127 ) << 23 ) + 0xfff + odd;
+            result = u >> 13;
+        }
+
+        return static_cast<uint16_t>( result | ( sign >> 16 ) );
+#endif
+    }
+
+    /// \returns the float equal to binary16 \a h
+    inline float half_bits_to_float( uint16_t h )
+    {
+#if defined(__F16C__)
+        return _cvtsh_ss( h );
+#else
+        constexpr uint32_t shifted_exponent = 0x7c00u << 13;
+
+        uint32_t u = ( h & 0x7fffu ) << 13;
+        const uint32_t exponent = u & shifted_exponent;
+        u += ( 127 - 15 ) << 23;
+        if ( exponent == shifted_exponent )
+        {
+            // infinity or NaN
+            u += ( 128 - 16 ) << 23;
+        }
+        else if ( exponent == 0 )
+        {
+            // subnormal or zero: renormalize
+            u += 1 << 23;
+            u = float_bits( bits_float( u ) - bits_float( 113u << 23 ) );
+        }
+
+        return bits_float( u | ( uint32_t( h & 0x8000u ) << 16 ) );
+#endif
+    }
+
+    /// \returns the bfloat16 nearest to \a f, rounding ties to even;
+    /// NaNs stay (quiet) NaNs
+    inline uint16_t float_to_bfloat16_bits( float f )
+    {
+        const uint32_t u = float_bits( f );
+        if ( ( u & 0x7fffffffu ) > 0x7f800000u )
+            return static_cast<uint16_t>( ( u >> 16 ) | 0x40 );
+
+        return static_cast<uint16_t>( ( u + 0x7fffu + ( ( u >> 16 ) & 1 ) ) >> 16 );
+    }
+
+    /// \returns the float equal to bfloat16 \a b
+    inline float bfloat16_bits_to_float( uint16_t b )
+    {
+        return bits_float( uint32_t( b ) << 16 );
+    }
+
+}
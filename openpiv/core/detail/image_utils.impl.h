@@ -4,15 +4,19 @@
 // std
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <type_traits>
 #include <vector>
 
 // local
+#include "core/detail/convolution.h"
 #include "core/exception_builder.h"
+#include "core/fixed_image.h"
 #include "core/image.h"
 #include "core/image_view.h"
 #include "core/image_type_traits.h"
 #include "core/log.h"
+#include "core/parallel.h"
 
 namespace logger = openpiv::core::logger;
 
@@ -73,6 +77,79 @@ ReturnT find_peaks( const ImageT<ContainedT>& im, uint16_t num_peaks, uint32_t p
     return result;
 }
 
+/// Find highest \a num_peaks peaks in an image and return copies of
+/// their neighbourhoods; candidates are as for find_peaks, but only
+/// the best \a num_peaks are kept, in order, while scanning
+template < uint32_t Radius,
+           template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT,
+           typename
+           >
+ReturnT find_fixed_peaks( const ImageT<ContainedT>& im, uint16_t num_peaks )
+{
+    constexpr uint32_t result_w = 2*Radius + 1;
+
+    ReturnT result;
+    if ( num_peaks == 0 || im.width() < result_w || im.height() < result_w )
+        return result;
+
+    result.reserve( num_peaks );
+    const auto centre = []( const auto& peak ) -> const ContainedT& { return peak[{Radius, Radius}]; };
+
+    for ( uint32_t h=Radius; h<im.height()-2*Radius; ++h )
+    {
+        const ContainedT* above = im.line( h-1 );
+        const ContainedT* line = im.line( h );
+        const ContainedT* below = im.line( h+1 );
+
+        for ( uint32_t w=Radius; w<im.width()-Radius; ++w )
+        {
+            // check we have peak on this line before checking above and below
+            if ( line[w-1] < line[w] && line[w+1] < line[w] && above[w] < line[w] && below[w] < line[w] )
+            {
+                if ( result.size() == num_peaks && !( centre( result.back() ) < line[w] ) )
+                    continue;
+
+                auto it = std::upper_bound( std::begin(result), std::end(result), line[w],
+                                            [&centre]( const ContainedT& v, const auto& peak ) { return centre( peak ) < v; } );
+                const auto i = std::distance( std::begin(result), it );
+                if ( result.size() == num_peaks )
+                    result.pop_back();
+                result.insert( std::begin(result) + i,
+                               ReturnT::value_type::copy_from( im, {w - Radius, h - Radius} ) );
+            }
+        }
+    }
+
+    return result;
+}
+
+namespace detail {
+
+    /// offset of a Gaussian fitted to the centre of a 3x3 peak
+    template < typename result_t, typename PeakT >
+    result_t fit_simple_gaussian( const PeakT& im )
+    {
+        auto f = []( auto l, auto c, auto r ) {
+                     double num = log(l) - log(r);
+                     double den = 2.0*(log(l) + log(r) - 2.0*log(c));
+
+                     if ( den == 0.0 )
+                         return 0.0;
+
+                     return num/den;
+                 };
+
+        result_t result{ im.rect().midpoint() };
+        result[0] += f(im[{0, 1}], im[{1, 1}], im[{2, 1}]);
+        result[1] += f(im[{1, 0}], im[{1, 1}], im[{1, 2}]);
+
+        return result;
+    }
+
+}
+
 /// Fit two one-dimensional Gaussian curves to a peak
 template < template<typename> class ImageT,
            typename ContainedT,
@@ -83,21 +160,15 @@ result_t fit_simple_gaussian( const ImageT<ContainedT>& im )
     if ( im.size() != size{3, 3} )
         exception_builder<std::runtime_error>() << "fit_simple_gaussian: input must be 3x3";
 
-    auto f = []( auto l, auto c, auto r ) {
-                 double num = log(l) - log(r);
-                 double den = 2.0*(log(l) + log(r) - 2.0*log(c));
-
-                 if ( den == 0.0 )
-                     return 0.0;
-
-                 return num/den;
-             };
-
-    result_t result{ im.rect().midpoint() };
-    result[0] += f(im[{0, 1}], im[{1, 1}], im[{2, 1}]);
-    result[1] += f(im[{1, 0}], im[{1, 1}], im[{1, 2}]);
+    return detail::fit_simple_gaussian<result_t>( im );
+}
 
-    return result;
+template < typename ContainedT,
+           typename result_t
+           >
+result_t fit_simple_gaussian( const fixed_image<ContainedT, 3, 3>& im )
+{
+    return detail::fit_simple_gaussian<result_t>( im );
 }
 
 /// apply a function to each pixel
@@ -156,12 +227,9 @@ template < template<typename> class ImageT,
 ReturnT pixel_sum_impl( const ImageT<ContainedT>& im )
 {
     ReturnT result = 0;
-    auto p = std::begin( im );
-    const auto e = std::end( im );
-    while ( p != e )
-    {
-        result += *p++;
-    }
+    for ( auto row : im.rows() )
+        for ( const auto& p : row )
+            result += p;
 
     return result;
 }
@@ -217,7 +285,7 @@ ReturnT split_to_channels( const ImageT<rgba<T>>& rgba )
         ++p;
     }
 
-    return std::make_tuple( r_im, g_im, b_im, a_im );
+    return std::make_tuple( std::move( r_im ), std::move( g_im ), std::move( b_im ), std::move( a_im ) );
 }
 
 /// join channels into an RGBA image
@@ -282,7 +350,7 @@ ReturnT split_to_channels( const ImageT<complex<T>>& c )
         ++p;
     }
 
-    return std::make_tuple( real_im, imag_im );
+    return std::make_tuple( std::move( real_im ), std::move( imag_im ) );
 }
 
 /// join two images into a Complex image
@@ -337,12 +405,31 @@ ReturnT& transpose( const ImageT<ContainedT>& in, ImageT<ContainedT>& out )
     for ( uint32_t h=0; h<out.height(); ++h )
         olines[h] = out.line(h);
 
-    for ( uint32_t h=0; h<in.height(); ++h )
-    {
-        const ContainedT* p = in.line(h);
-        for ( uint32_t w=0; w<in.width(); ++w )
-            *olines[w]++ = *p++;
-    }
+    // copy in square tiles so that both the rows read and the rows
+    // written stay in cache; large images are split by bands of tiles
+    constexpr uint32_t tile = 8;
+    const uint32_t width = in.width();
+    const uint32_t tile_rows = ( in.height() + tile - 1 ) / tile;
+    parallel_for_blocks(
+        tile_rows,
+        [&in, &olines, width]( size_t first, size_t last )
+        {
+            for ( uint32_t h0 = first * tile; h0 < std::min<size_t>( last * tile, in.height() ); h0 += tile )
+            {
+                const uint32_t h1 = std::min( h0 + tile, in.height() );
+                for ( uint32_t w0 = 0; w0 < width; w0 += tile )
+                {
+                    const uint32_t w1 = std::min( w0 + tile, width );
+                    for ( uint32_t h = h0; h < h1; ++h )
+                    {
+                        const ContainedT* p = in.line(h);
+                        for ( uint32_t w = w0; w < w1; ++w )
+                            olines[w][h] = p[w];
+                    }
+                }
+            }
+        },
+        std::max<size_t>( 1, image<ContainedT>::parallel_pixels / ( size_t{tile} * std::max<uint32_t>( width, 1 ) ) ) );
 
     return out;
 }
@@ -418,5 +505,219 @@ image<ContainedT> extract( const ImageT<ContainedT>& im, core::rect r )
     return result;
 }
 
+namespace detail {
+
+    using filter_image_t = image< g<float> >;
+
+    /// rows filtered together by the recursive row kernels
+    constexpr size_t filter_row_group = 4;
+
+    /// call \a pass for groups of up to filter_row_group rows of \a im:
+    ///
+    /// void pass( float* const* rows, size_t count, size_t n, float* buffer )
+    ///
+    /// in parallel over bands of rows; \a buffer has room for \a
+    /// padding values either side of each row
+    template < typename F >
+    void filter_image_rows( filter_image_t& im, size_t padding, F pass )
+    {
+        const uint32_t w = im.width();
+        parallel_for_blocks(
+            im.height(),
+            [&im, w, padding, &pass]( size_t first, size_t last )
+            {
+                std::vector<float> buffer( filter_row_group * ( w + 2 * padding ) );
+                float* rows[filter_row_group];
+                for ( size_t h=first; h<last; h+=filter_row_group )
+                {
+                    const size_t count = std::min( filter_row_group, last - h );
+                    for ( size_t l=0; l<count; ++l )
+                        rows[l] = &im.line( h + l )->v;
+                    pass( rows, count, w, buffer.data() );
+                }
+            },
+            std::max<size_t>( filter_row_group, filter_image_t::parallel_pixels / std::max<uint32_t>( w, 1 ) ) );
+    }
+
+    /// call \a kernel< filter_row_group > for a whole group of rows,
+    /// otherwise \a kernel< 1 > for each row
+    template < template<size_t> class Kernel, typename... Args >
+    inline void filter_row_group_with( float* const* rows, size_t count, Args&&... args )
+    {
+        if ( count == filter_row_group )
+            Kernel<filter_row_group>{}( rows, args... );
+        else
+            for ( size_t l=0; l<count; ++l )
+                Kernel<1>{}( rows + l, args... );
+    }
+
+    /// the grouped row kernels as function objects, for
+    /// filter_row_group_with
+    template < size_t L >
+    struct box_rows_kernel
+    {
+        void operator()( float* const* rows, size_t n, size_t r, float* buffer ) const { box_rows<L>( rows, n, r, buffer ); }
+    };
+
+    template < size_t L >
+    struct recursive_gaussian_rows_kernel
+    {
+        void operator()( float* const* rows, size_t n, const recursive_gaussian_coefficients& c ) const { recursive_gaussian_rows<L>( rows, n, c ); }
+    };
+
+    /// \returns \a v as pixel type \a P; integers are rounded and
+    /// clamped to their range
+    template < typename P >
+    inline P from_filtered( float v )
+    {
+        using value_t = typename P::value_t;
+        if constexpr ( std::is_integral_v<value_t> )
+        {
+            const double clamped = std::clamp<double>( v, std::numeric_limits<value_t>::min(), std::numeric_limits<value_t>::max() );
+            if constexpr ( std::is_signed_v<value_t> )
+                return P( static_cast<value_t>( std::llround( clamped ) ) );
+            else
+                return P( static_cast<value_t>( clamped + 0.5 ) );
+        }
+        else
+            return P( v );
+    }
+
+    /// separable filter of \a im: \a row_pass over the rows then \a
+    /// column_pass over the rows of the transpose, each as for
+    /// filter_image_rows
+    template < typename ReturnT,
+               template<typename> class ImageT,
+               typename ContainedT,
+               typename FX,
+               typename FY >
+    ReturnT separable_filter( const ImageT<ContainedT>& im,
+                              size_t x_padding, FX row_pass,
+                              size_t y_padding, FY column_pass )
+    {
+        if ( im.size().area() == 0 )
+            return ReturnT{ im.size() };
+
+        filter_image_t filtered{ im };
+        filter_image_rows( filtered, x_padding, row_pass );
+        filter_image_t transposed{ transpose( filtered ) };
+        filter_image_rows( transposed, y_padding, column_pass );
+        transpose( transposed, filtered );
+
+        using pixel_t = typename ReturnT::pixel_t;
+        ReturnT result{ im.size() };
+        for ( uint32_t h=0; h<result.height(); ++h )
+        {
+            const g<float>* in = filtered.line(h);
+            pixel_t* out = result.line(h);
+            for ( uint32_t w=0; w<result.width(); ++w )
+                out[w] = from_filtered<pixel_t>( in[w].v );
+        }
+
+        return result;
+    }
+
+    /// \returns \a k reversed in single precision, for convolution
+    inline std::vector<float> convolution_taps( const std::vector<double>& k, const char* name )
+    {
+        if ( k.size() % 2 == 0 )
+            exception_builder<std::invalid_argument>()
+                << "convolve_separable: " << name << " must have an odd number of taps: " << k.size();
+
+        return { k.rbegin(), k.rend() };
+    }
+
+}
+
+/// convolve a greyscale image with a separable kernel
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT,
+           typename
+           >
+ReturnT convolve_separable( const ImageT<ContainedT>& im,
+                            const std::vector<double>& kx,
+                            const std::vector<double>& ky )
+{
+    const std::vector<float> tx = detail::convolution_taps( kx, "kx" );
+    const std::vector<float> ty = detail::convolution_taps( ky, "ky" );
+    const auto pass = []( const std::vector<float>& taps )
+                      {
+                          return [&taps]( float* const* rows, size_t count, size_t n, float* buffer )
+                                 {
+                                     for ( size_t l=0; l<count; ++l )
+                                         detail::filter_row( rows[l], n, taps.data(), taps.size(), buffer );
+                                 };
+                      };
+
+    return detail::separable_filter<ReturnT>( im, tx.size() / 2, pass( tx ), ty.size() / 2, pass( ty ) );
+}
+
+/// normalized, sampled Gaussian
+inline std::vector<double> gaussian_kernel( double sigma, uint32_t radius )
+{
+    if ( !( sigma > 0 ) )
+        exception_builder<std::invalid_argument>() << "gaussian_kernel: sigma must be positive: " << sigma;
+
+    if ( radius == 0 )
+        radius = static_cast<uint32_t>( std::ceil( 3 * sigma ) );
+
+    std::vector<double> result( 2 * radius + 1 );
+    double sum = 0;
+    for ( uint32_t i=0; i<result.size(); ++i )
+    {
+        const double x = static_cast<double>( i ) - radius;
+        result[i] = std::exp( -x * x / ( 2 * sigma * sigma ) );
+        sum += result[i];
+    }
+    for ( auto& k : result )
+        k /= sum;
+
+    return result;
+}
+
+/// Gaussian blur by convolution
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT,
+           typename
+           >
+ReturnT gaussian_blur( const ImageT<ContainedT>& im, double sigma )
+{
+    const auto k = gaussian_kernel( sigma );
+    return convolve_separable<ImageT, ContainedT, ReturnT>( im, k, k );
+}
+
+/// box blur by running sums
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT,
+           typename
+           >
+ReturnT box_blur( const ImageT<ContainedT>& im, uint32_t radius )
+{
+    const auto pass = [radius]( float* const* rows, size_t count, size_t n, float* buffer )
+                      {
+                          detail::filter_row_group_with<detail::box_rows_kernel>( rows, count, n, size_t{radius}, buffer );
+                      };
+    return detail::separable_filter<ReturnT>( im, radius, pass, radius, pass );
+}
+
+/// recursive Gaussian blur
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT,
+           typename
+           >
+ReturnT recursive_gaussian_blur( const ImageT<ContainedT>& im, double sigma )
+{
+    const detail::recursive_gaussian_coefficients c( sigma );
+    const auto pass = [&c]( float* const* rows, size_t count, size_t n, float* )
+                      {
+                          detail::filter_row_group_with<detail::recursive_gaussian_rows_kernel>( rows, count, n, c );
+                      };
+    return detail::separable_filter<ReturnT>( im, 0, pass, 0, pass );
+}
+
 
 }
@@ -0,0 +1,371 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "core/pixel_types.h"
+
+namespace openpiv::core::detail {
+
+    /// outputs at least this large are written with non-temporal
+    /// stores by the converters that support them: they would not fit
+    /// in cache anyway, and this saves reading each line before it is
+    /// overwritten
+    constexpr size_t streaming_store_bytes = size_t{1} << 25;
+
+    /// convert \a n pixels from \a in to \a out; this is the fallback
+    /// for pixel types without a vectorized converter below. \a stream
+    /// requests non-temporal stores where supported
+    template < typename From, typename To >
+    inline void convert_row( const From* in, To* out, size_t n, bool /* stream */ = false )
+    {
+        for ( size_t i=0; i<n; ++i )
+            convert( in[i], out[i] );
+    }
+
+    /// greyscale to complex; written in terms of the underlying
+    /// values so the compiler vectorizes it
+    template < typename From, typename To >
+    inline void convert_row( const g<From>* in, complex<To>* out, size_t n, bool /* stream */ = false )
+    {
+        for ( size_t i=0; i<n; ++i )
+        {
+            out[i].real = static_cast<To>( in[i].v );
+            out[i].imag = To{};
+        }
+    }
+
+#if defined(__AVX2__)
+    /// store 8 32-bit integers \a x to \a out as float or double;
+    /// \a out must be 32 byte aligned if \a Stream is set
+    template < bool Stream, typename To >
+    inline void store8( To* out, __m256i x )
+    {
+        if constexpr ( std::is_same_v<To, float> )
+        {
+            const __m256 v = _mm256_cvtepi32_ps( x );
+            if constexpr ( Stream )
+                _mm256_stream_ps( out, v );
+            else
+                _mm256_storeu_ps( out, v );
+        }
+        else
+        {
+            const __m256d lo = _mm256_cvtepi32_pd( _mm256_castsi256_si128( x ) );
+            const __m256d hi = _mm256_cvtepi32_pd( _mm256_extracti128_si256( x, 1 ) );
+            if constexpr ( Stream )
+            {
+                _mm256_stream_pd( out, lo );
+                _mm256_stream_pd( out + 4, hi );
+            }
+            else
+            {
+                _mm256_storeu_pd( out, lo );
+                _mm256_storeu_pd( out + 4, hi );
+            }
+        }
+    }
+
+    /// call \a block( i, stream ) for each block of 8 pixels of \a n;
+    /// when \a stream is set, pixels before the first 32 byte aligned
+    /// output are converted by \a scalar( i ) first
+    /// \returns the number of pixels handled
+    template < typename To, typename B, typename S >
+    inline size_t for_each_block8( To* out, size_t n, bool stream, B block, S scalar )
+    {
+        size_t i = 0;
+        if ( !stream )
+        {
+            for ( ; i + 8 <= n; i += 8 )
+                block( i, std::false_type{} );
+            return i;
+        }
+
+        for ( ; i < n && reinterpret_cast<uintptr_t>( out + i ) % 32 != 0; ++i )
+            scalar( i );
+        for ( ; i + 8 <= n; i += 8 )
+            block( i, std::true_type{} );
+        _mm_sfence();
+        return i;
+    }
+#endif
+
+    /// unsigned integer greyscale to floating point greyscale: values
+    /// are zero-extended to 32-bit lanes and converted; any remainder
+    /// is handled by the scalar conversion
+    template < typename From, typename To >
+    inline void widen_row( const From* in, To* out, size_t n, bool stream )
+    {
+        const auto scalar = [in, out]( size_t i ){ out[i] = static_cast<To>( in[i] ); };
+#if !defined(__AVX2__)
+        static_cast<void>( stream );
+#endif
+
+        size_t i = 0;
+#if defined(__AVX2__)
+        i = for_each_block8(
+            out, n, stream,
+            [in, out]( size_t i, auto streamed )
+            {
+                __m256i x;
+                if constexpr ( sizeof(From) == 1 )
+                    x = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( in + i ) ) );
+                else
+                    x = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( in + i ) ) );
+                store8< decltype( streamed )::value >( out + i, x );
+            },
+            scalar );
+#elif defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            __m128i x16;
+            if constexpr ( sizeof(From) == 1 )
+                x16 = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( in + i ) ), zero );
+            else
+                x16 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in + i ) );
+
+            const __m128i lo = _mm_unpacklo_epi16( x16, zero );
+            const __m128i hi = _mm_unpackhi_epi16( x16, zero );
+            if constexpr ( std::is_same_v<To, float> )
+            {
+                _mm_storeu_ps( out + i, _mm_cvtepi32_ps( lo ) );
+                _mm_storeu_ps( out + i + 4, _mm_cvtepi32_ps( hi ) );
+            }
+            else
+            {
+                _mm_storeu_pd( out + i, _mm_cvtepi32_pd( lo ) );
+                _mm_storeu_pd( out + i + 2, _mm_cvtepi32_pd( _mm_unpackhi_epi64( lo, lo ) ) );
+                _mm_storeu_pd( out + i + 4, _mm_cvtepi32_pd( hi ) );
+                _mm_storeu_pd( out + i + 6, _mm_cvtepi32_pd( _mm_unpackhi_epi64( hi, hi ) ) );
+            }
+        }
+#endif
+        for ( ; i<n; ++i )
+            scalar( i );
+    }
+
+    inline void convert_row( const g_8* in, g_f* out, size_t n, bool stream = false )
+    {
+        widen_row( reinterpret_cast<const uint8_t*>( in ), reinterpret_cast<double*>( out ), n, stream );
+    }
+
+    inline void convert_row( const g_16* in, g_f* out, size_t n, bool stream = false )
+    {
+        widen_row( reinterpret_cast<const uint16_t*>( in ), reinterpret_cast<double*>( out ), n, stream );
+    }
+
+    inline void convert_row( const g_8* in, g<float>* out, size_t n, bool stream = false )
+    {
+        widen_row( reinterpret_cast<const uint8_t*>( in ), reinterpret_cast<float*>( out ), n, stream );
+    }
+
+    inline void convert_row( const g_16* in, g<float>* out, size_t n, bool stream = false )
+    {
+        widen_row( reinterpret_cast<const uint16_t*>( in ), reinterpret_cast<float*>( out ), n, stream );
+    }
+
+    /// integer rgba to greyscale using the weights of the scalar
+    /// convert(), (218 r + 732 g + 74 b) >> 10: the channels of each
+    /// pixel are multiplied and pairwise added by madd; 16-bit channels
+    /// are biased into signed range first and the bias, 32768 * 1024,
+    /// added back to the weighted sum. Any remainder is handled by the
+    /// scalar conversion
+    template < typename From, typename To >
+    inline void rgba_to_grey_row( const rgba<From>* in, g<To>* out, size_t n, bool stream )
+    {
+        const auto scalar = [in, out]( size_t i ){ convert( in[i], out[i] ); };
+#if !defined(__AVX2__)
+        static_cast<void>( stream );
+#endif
+
+        size_t i = 0;
+#if defined(__AVX2__)
+        const auto grey8 = [in]( size_t i )
+                           {
+                               const __m256i weights = _mm256_setr_epi16( 218, 732, 74, 0, 218, 732, 74, 0,
+                                                                          218, 732, 74, 0, 218, 732, 74, 0 );
+                               __m256i p0, p1;
+                               if constexpr ( sizeof(From) == 1 )
+                               {
+                                   const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( in + i ) );
+                                   p0 = _mm256_cvtepu8_epi16( _mm256_castsi256_si128( x ) );
+                                   p1 = _mm256_cvtepu8_epi16( _mm256_extracti128_si256( x, 1 ) );
+                               }
+                               else
+                               {
+                                   const __m256i bias = _mm256_set1_epi16( static_cast<int16_t>( 0x8000 ) );
+                                   p0 = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( in + i ) ), bias );
+                                   p1 = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( in + i + 4 ) ), bias );
+                               }
+
+                               // [p0 p1 p4 p5 | p2 p3 p6 p7] -> [p0 ... p7]
+                               __m256i y = _mm256_hadd_epi32( _mm256_madd_epi16( p0, weights ),
+                                                              _mm256_madd_epi16( p1, weights ) );
+                               y = _mm256_permute4x64_epi64( y, 0xd8 );
+                               if constexpr ( sizeof(From) != 1 )
+                                   y = _mm256_add_epi32( y, _mm256_set1_epi32( 32768 * 1024 ) );
+                               return _mm256_srli_epi32( y, 10 );
+                           };
+
+        if constexpr ( std::is_floating_point_v<To> )
+            i = for_each_block8(
+                reinterpret_cast<To*>( out ), n, stream,
+                [out, &grey8]( size_t i, auto streamed )
+                {
+                    store8< decltype( streamed )::value >( reinterpret_cast<To*>( out + i ), grey8( i ) );
+                },
+                scalar );
+        else
+            for ( ; i + 8 <= n; i += 8 )
+            {
+                const __m256i y = grey8( i );
+                const __m128i y16 = _mm_packus_epi32( _mm256_castsi256_si128( y ), _mm256_extracti128_si256( y, 1 ) );
+                if constexpr ( sizeof(To) == 2 )
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( out + i ), y16 );
+                else
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>( out + i ), _mm_packus_epi16( y16, y16 ) );
+            }
+#endif
+        for ( ; i<n; ++i )
+            scalar( i );
+    }
+
+    inline void convert_row( const rgba_8* in, g_8* out, size_t n, bool stream = false ) { rgba_to_grey_row( in, out, n, stream ); }
+    inline void convert_row( const rgba_8* in, g_16* out, size_t n, bool stream = false ) { rgba_to_grey_row( in, out, n, stream ); }
+    inline void convert_row( const rgba_8* in, g_f* out, size_t n, bool stream = false ) { rgba_to_grey_row( in, out, n, stream ); }
+    inline void convert_row( const rgba_16* in, g_16* out, size_t n, bool stream = false ) { rgba_to_grey_row( in, out, n, stream ); }
+    inline void convert_row( const rgba_16* in, g_f* out, size_t n, bool stream = false ) { rgba_to_grey_row( in, out, n, stream ); }
+
+    /// conversions to and from the 16-bit floating point storage
+    /// types go through 8 floats at a time: half with F16C, bfloat16
+    /// by shifting into the top of a float with rounding to nearest
+    /// even. Any remainder is handled by the scalar conversion
+#if defined(__AVX2__)
+    inline __m256 load8_ps( const float* p ) { return _mm256_loadu_ps( p ); }
+
+    inline __m256 load8_ps( const double* p )
+    {
+        return _mm256_set_m128( _mm256_cvtpd_ps( _mm256_loadu_pd( p + 4 ) ), _mm256_cvtpd_ps( _mm256_loadu_pd( p ) ) );
+    }
+
+    inline __m256 load8_ps( const uint16_t* p )
+    {
+        return _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ) ) );
+    }
+
+    inline __m256 load8_ps( const bfloat16* p )
+    {
+        const __m256i x = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ) );
+        return _mm256_castsi256_ps( _mm256_slli_epi32( x, 16 ) );
+    }
+
+    inline void store8_ps( float* p, __m256 v ) { _mm256_storeu_ps( p, v ); }
+
+    inline void store8_ps( double* p, __m256 v )
+    {
+        _mm256_storeu_pd( p, _mm256_cvtps_pd( _mm256_castps256_ps128( v ) ) );
+        _mm256_storeu_pd( p + 4, _mm256_cvtps_pd( _mm256_extractf128_ps( v, 1 ) ) );
+    }
+
+    /// complex with zero imaginary parts
+    inline void store8_ps( complex<double>* p, __m256 v )
+    {
+        const __m256d zero = _mm256_setzero_pd();
+        double* out = reinterpret_cast<double*>( p );
+        for ( int k = 0; k < 2; ++k )
+        {
+            const __m256d d = _mm256_cvtps_pd( k ? _mm256_extractf128_ps( v, 1 ) : _mm256_castps256_ps128( v ) );
+
+            // [d0 0 | d2 0], [d1 0 | d3 0] -> [d0 0 d1 0], [d2 0 d3 0]
+            const __m256d lo = _mm256_unpacklo_pd( d, zero );
+            const __m256d hi = _mm256_unpackhi_pd( d, zero );
+            _mm256_storeu_pd( out + 8*k, _mm256_permute2f128_pd( lo, hi, 0x20 ) );
+            _mm256_storeu_pd( out + 8*k + 4, _mm256_permute2f128_pd( lo, hi, 0x31 ) );
+        }
+    }
+
+    inline void store8_ps( bfloat16* p, __m256 v )
+    {
+        const __m256i x = _mm256_castps_si256( v );
+        const __m256i odd = _mm256_and_si256( _mm256_srli_epi32( x, 16 ), _mm256_set1_epi32( 1 ) );
+        __m256i y = _mm256_srli_epi32( _mm256_add_epi32( x, _mm256_add_epi32( odd, _mm256_set1_epi32( 0x7fff ) ) ), 16 );
+
+        // NaNs stay quiet NaNs rather than rounding to infinity
+        const __m256i nan = _mm256_castps_si256( _mm256_cmp_ps( v, v, _CMP_UNORD_Q ) );
+        const __m256i quiet = _mm256_or_si256( _mm256_srli_epi32( x, 16 ), _mm256_set1_epi32( 0x40 ) );
+        y = _mm256_blendv_epi8( y, quiet, nan );
+
+        const __m128i y16 = _mm_packus_epi32( _mm256_castsi256_si128( y ), _mm256_extracti128_si256( y, 1 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), y16 );
+    }
+
+#if defined(__F16C__)
+    inline __m256 load8_ps( const half* p )
+    {
+        return _mm256_cvtph_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ) );
+    }
+
+    inline void store8_ps( half* p, __m256 v )
+    {
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), _mm256_cvtps_ph( v, _MM_FROUND_TO_NEAREST_INT ) );
+    }
+#endif
+#endif
+
+    /// convert \a n values of \a in to \a out through float, 8 at a
+    /// time where load8_ps and store8_ps exist for the value types
+    template < typename From, typename To, typename FromValueT, typename ToValueT >
+    inline void convert_via_float( const From* in, To* out, size_t n )
+    {
+        static_assert( sizeof(From) == sizeof(FromValueT) && sizeof(To) == sizeof(ToValueT) );
+
+        size_t i = 0;
+#if defined(__AVX2__)
+        constexpr bool has_load = std::is_same_v<FromValueT, float> || std::is_same_v<FromValueT, double> ||
+            std::is_same_v<FromValueT, uint16_t> || std::is_same_v<FromValueT, bfloat16>
+#if defined(__F16C__)
+            || std::is_same_v<FromValueT, half>
+#endif
+            ;
+        constexpr bool has_store = std::is_same_v<ToValueT, float> || std::is_same_v<ToValueT, double> ||
+            std::is_same_v<ToValueT, complex<double>> || std::is_same_v<ToValueT, bfloat16>
+#if defined(__F16C__)
+            || std::is_same_v<ToValueT, half>
+#endif
+            ;
+        if constexpr ( has_load && has_store )
+        {
+            const FromValueT* from = reinterpret_cast<const FromValueT*>( in );
+            ToValueT* to = reinterpret_cast<ToValueT*>( out );
+            for ( ; i + 8 <= n; i += 8 )
+                store8_ps( to + i, load8_ps( from + i ) );
+        }
+#endif
+        for ( ; i<n; ++i )
+            convert( in[i], out[i] );
+    }
+
+    inline void convert_row( const g_h* in, g_f* out, size_t n, bool = false ) { convert_via_float<g_h, g_f, half, double>( in, out, n ); }
+    inline void convert_row( const g_h* in, g<float>* out, size_t n, bool = false ) { convert_via_float<g_h, g<float>, half, float>( in, out, n ); }
+    inline void convert_row( const g_h* in, c_f* out, size_t n, bool = false ) { convert_via_float<g_h, c_f, half, c_f>( in, out, n ); }
+    inline void convert_row( const g_f* in, g_h* out, size_t n, bool = false ) { convert_via_float<g_f, g_h, double, half>( in, out, n ); }
+    inline void convert_row( const g<float>* in, g_h* out, size_t n, bool = false ) { convert_via_float<g<float>, g_h, float, half>( in, out, n ); }
+    inline void convert_row( const g_16* in, g_h* out, size_t n, bool = false ) { convert_via_float<g_16, g_h, uint16_t, half>( in, out, n ); }
+
+    inline void convert_row( const g_bf* in, g_f* out, size_t n, bool = false ) { convert_via_float<g_bf, g_f, bfloat16, double>( in, out, n ); }
+    inline void convert_row( const g_bf* in, g<float>* out, size_t n, bool = false ) { convert_via_float<g_bf, g<float>, bfloat16, float>( in, out, n ); }
+    inline void convert_row( const g_bf* in, c_f* out, size_t n, bool = false ) { convert_via_float<g_bf, c_f, bfloat16, c_f>( in, out, n ); }
+    inline void convert_row( const g_f* in, g_bf* out, size_t n, bool = false ) { convert_via_float<g_f, g_bf, double, bfloat16>( in, out, n ); }
+    inline void convert_row( const g<float>* in, g_bf* out, size_t n, bool = false ) { convert_via_float<g<float>, g_bf, float, bfloat16>( in, out, n ); }
+    inline void convert_row( const g_16* in, g_bf* out, size_t n, bool = false ) { convert_via_float<g_16, g_bf, uint16_t, bfloat16>( in, out, n ); }
+
+}
@@ -0,0 +1,85 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace openpiv::core::detail {
+
+    /// in-place inclusive prefix sum of \a n values
+    template < typename T >
+    inline void inclusive_scan( T* data, size_t n, size_t i = 0 )
+    {
+        T running = i > 0 ? data[i - 1] : T{};
+        for ( ; i<n; ++i )
+            data[i] = running += data[i];
+    }
+
+    /// vectorized scans: each block is scanned in-register using
+    /// log2(lanes) shift & add steps and the carry from the previous
+    /// block is then broadcast into all lanes; any remainder is
+    /// handled by the scalar scan
+    inline void inclusive_scan( double* data, size_t n )
+    {
+        size_t i = 0;
+#if defined(__AVX__)
+        __m256d carry = _mm256_setzero_pd();
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            __m256d x = _mm256_loadu_pd( data + i );
+            // [a, a+b, c, c+d]
+            x = _mm256_add_pd( x, _mm256_blend_pd( _mm256_permute_pd( x, 0b0101 ), _mm256_setzero_pd(), 0b0101 ) );
+            // [a, a+b, a+b+c, a+b+c+d]
+            x = _mm256_add_pd( x, _mm256_permute_pd( _mm256_permute2f128_pd( x, x, 0x08 ), 0b1100 ) );
+            x = _mm256_add_pd( x, carry );
+            _mm256_storeu_pd( data + i, x );
+            carry = _mm256_permute_pd( _mm256_permute2f128_pd( x, x, 0x11 ), 0b1111 );
+        }
+#elif defined(__SSE2__)
+        __m128d carry = _mm_setzero_pd();
+        for ( ; i + 2 <= n; i += 2 )
+        {
+            __m128d x = _mm_loadu_pd( data + i );
+            x = _mm_add_pd( x, _mm_castsi128_pd( _mm_slli_si128( _mm_castpd_si128( x ), 8 ) ) );
+            x = _mm_add_pd( x, carry );
+            _mm_storeu_pd( data + i, x );
+            carry = _mm_unpackhi_pd( x, x );
+        }
+#endif
+        inclusive_scan<double>( data, n, i );
+    }
+
+    inline void inclusive_scan( int64_t* data, size_t n )
+    {
+        size_t i = 0;
+#if defined(__AVX2__)
+        __m256i carry = _mm256_setzero_si256();
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + i ) );
+            x = _mm256_add_epi64( x, _mm256_slli_si256( x, 8 ) );
+            x = _mm256_add_epi64( x, _mm256_blend_epi32( _mm256_permute4x64_epi64( x, 0x50 ), _mm256_setzero_si256(), 0x0f ) );
+            x = _mm256_add_epi64( x, carry );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( data + i ), x );
+            carry = _mm256_permute4x64_epi64( x, 0xff );
+        }
+#elif defined(__SSE2__)
+        __m128i carry = _mm_setzero_si128();
+        for ( ; i + 2 <= n; i += 2 )
+        {
+            __m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + i ) );
+            x = _mm_add_epi64( x, _mm_slli_si128( x, 8 ) );
+            x = _mm_add_epi64( x, carry );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( data + i ), x );
+            carry = _mm_unpackhi_epi64( x, x );
+        }
+#endif
+        inclusive_scan<int64_t>( data, n, i );
+    }
+
+}
@@ -0,0 +1,273 @@
+
+#pragma once
+
+// std
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// local
+#include "core/pixel_types.h"
+
+namespace openpiv::core::detail {
+
+    /// row kernels for split complex (planar) data: the real and
+    /// imaginary parts are in separate arrays so that complex
+    /// arithmetic is done lane by lane without shuffles. The generic
+    /// versions are plain loops; the double precision overloads below
+    /// are vectorized with AVX or SSE2 and have a scalar tail.
+
+    /// \a re, \a im from interleaved \a in
+    template < typename T >
+    inline void deinterleave_row( const complex<T>* in, T* re, T* im, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+        {
+            re[i] = in[i].real;
+            im[i] = in[i].imag;
+        }
+    }
+
+    /// interleaved \a out from \a re, \a im
+    template < typename T >
+    inline void interleave_row( const T* re, const T* im, complex<T>* out, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+            out[i] = { re[i], im[i] };
+    }
+
+    /// b * conj( a ) into split \a re, \a im
+    template < typename T >
+    inline void conj_multiply_row( const T* a_re, const T* a_im,
+                                   const T* b_re, const T* b_im,
+                                   T* re, T* im, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+        {
+            const T r = b_re[i] * a_re[i] + b_im[i] * a_im[i];
+            const T j = b_im[i] * a_re[i] - b_re[i] * a_im[i];
+            re[i] = r;
+            im[i] = j;
+        }
+    }
+
+    /// b * conj( a ) into interleaved \a out
+    template < typename T >
+    inline void conj_multiply_row( const T* a_re, const T* a_im,
+                                   const T* b_re, const T* b_im,
+                                   complex<T>* out, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+            out[i] = { b_re[i] * a_re[i] + b_im[i] * a_im[i],
+                       b_im[i] * a_re[i] - b_re[i] * a_im[i] };
+    }
+
+    /// squared magnitude of \a re, \a im
+    template < typename T >
+    inline void abs_sqr_row( const T* re, const T* im, T* out, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+            out[i] = re[i] * re[i] + im[i] * im[i];
+    }
+
+    /// magnitude of \a re, \a im
+    template < typename T >
+    inline void abs_row( const T* re, const T* im, T* out, size_t n )
+    {
+        for ( size_t i=0; i<n; ++i )
+            out[i] = std::sqrt( re[i] * re[i] + im[i] * im[i] );
+    }
+
+    /// divide \a re, \a im by their magnitude; values with a
+    /// magnitude not greater than \a epsilon become zero
+    template < typename T >
+    inline void normalize_row( T* re, T* im, size_t n, T epsilon )
+    {
+        for ( size_t i=0; i<n; ++i )
+        {
+            const T m = std::sqrt( re[i] * re[i] + im[i] * im[i] );
+            const T s = m > epsilon ? T{1} / m : T{};
+            re[i] *= s;
+            im[i] *= s;
+        }
+    }
+
+#if defined(__SSE2__)
+    /// the double precision operations used by the kernels, on the
+    /// widest vectors available
+    struct simd_double
+    {
+#if defined(__AVX__)
+        using reg = __m256d;
+        static constexpr size_t lanes = 4;
+
+        static inline reg load( const double* p ) { return _mm256_loadu_pd( p ); }
+        static inline void store( double* p, reg x ) { _mm256_storeu_pd( p, x ); }
+        static inline reg set1( double v ) { return _mm256_set1_pd( v ); }
+        static inline reg add( reg a, reg b ) { return _mm256_add_pd( a, b ); }
+        static inline reg sub( reg a, reg b ) { return _mm256_sub_pd( a, b ); }
+        static inline reg mul( reg a, reg b ) { return _mm256_mul_pd( a, b ); }
+        static inline reg div( reg a, reg b ) { return _mm256_div_pd( a, b ); }
+        static inline reg sqrt( reg a ) { return _mm256_sqrt_pd( a ); }
+        static inline reg mask_gt( reg x, reg a, reg b ) { return _mm256_and_pd( _mm256_cmp_pd( a, b, _CMP_GT_OQ ), x ); }
+#if defined(__FMA__)
+        static inline reg fmadd( reg a, reg b, reg c ) { return _mm256_fmadd_pd( a, b, c ); }
+        static inline reg fnmadd( reg a, reg b, reg c ) { return _mm256_fnmadd_pd( a, b, c ); }
+#else
+        static inline reg fmadd( reg a, reg b, reg c ) { return add( mul( a, b ), c ); }
+        static inline reg fnmadd( reg a, reg b, reg c ) { return sub( c, mul( a, b ) ); }
+#endif
+
+        /// 2 * lanes interleaved values to/from separate vectors
+        static inline void interleave( reg re, reg im, double* out )
+        {
+            const reg lo = _mm256_unpacklo_pd( re, im );
+            const reg hi = _mm256_unpackhi_pd( re, im );
+            _mm256_storeu_pd( out, _mm256_permute2f128_pd( lo, hi, 0x20 ) );
+            _mm256_storeu_pd( out + 4, _mm256_permute2f128_pd( lo, hi, 0x31 ) );
+        }
+        static inline void deinterleave( const double* in, reg& re, reg& im )
+        {
+            const reg a = _mm256_loadu_pd( in );
+            const reg b = _mm256_loadu_pd( in + 4 );
+            const reg lo = _mm256_permute2f128_pd( a, b, 0x20 );
+            const reg hi = _mm256_permute2f128_pd( a, b, 0x31 );
+            re = _mm256_unpacklo_pd( lo, hi );
+            im = _mm256_unpackhi_pd( lo, hi );
+        }
+#else
+        using reg = __m128d;
+        static constexpr size_t lanes = 2;
+
+        static inline reg load( const double* p ) { return _mm_loadu_pd( p ); }
+        static inline void store( double* p, reg x ) { _mm_storeu_pd( p, x ); }
+        static inline reg set1( double v ) { return _mm_set1_pd( v ); }
+        static inline reg add( reg a, reg b ) { return _mm_add_pd( a, b ); }
+        static inline reg sub( reg a, reg b ) { return _mm_sub_pd( a, b ); }
+        static inline reg mul( reg a, reg b ) { return _mm_mul_pd( a, b ); }
+        static inline reg div( reg a, reg b ) { return _mm_div_pd( a, b ); }
+        static inline reg sqrt( reg a ) { return _mm_sqrt_pd( a ); }
+        static inline reg mask_gt( reg x, reg a, reg b ) { return _mm_and_pd( _mm_cmpgt_pd( a, b ), x ); }
+        static inline reg fmadd( reg a, reg b, reg c ) { return add( mul( a, b ), c ); }
+        static inline reg fnmadd( reg a, reg b, reg c ) { return sub( c, mul( a, b ) ); }
+
+        static inline void interleave( reg re, reg im, double* out )
+        {
+            _mm_storeu_pd( out, _mm_unpacklo_pd( re, im ) );
+            _mm_storeu_pd( out + 2, _mm_unpackhi_pd( re, im ) );
+        }
+        static inline void deinterleave( const double* in, reg& re, reg& im )
+        {
+            const reg a = _mm_loadu_pd( in );
+            const reg b = _mm_loadu_pd( in + 2 );
+            re = _mm_unpacklo_pd( a, b );
+            im = _mm_unpackhi_pd( a, b );
+        }
+#endif
+    };
+
+    inline void deinterleave_row( const complex<double>* in, double* re, double* im, size_t n )
+    {
+        using v = simd_double;
+        const double* in_d = &in->real;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            v::reg r, j;
+            v::deinterleave( in_d + 2*i, r, j );
+            v::store( re + i, r );
+            v::store( im + i, j );
+        }
+        deinterleave_row<double>( in + i, re + i, im + i, n - i );
+    }
+
+    inline void interleave_row( const double* re, const double* im, complex<double>* out, size_t n )
+    {
+        using v = simd_double;
+        double* out_d = &out->real;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+            v::interleave( v::load( re + i ), v::load( im + i ), out_d + 2*i );
+        interleave_row<double>( re + i, im + i, out + i, n - i );
+    }
+
+    inline void conj_multiply_row( const double* a_re, const double* a_im,
+                                   const double* b_re, const double* b_im,
+                                   double* re, double* im, size_t n )
+    {
+        using v = simd_double;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            const v::reg ar = v::load( a_re + i ), ai = v::load( a_im + i );
+            const v::reg br = v::load( b_re + i ), bi = v::load( b_im + i );
+            v::store( re + i, v::fmadd( br, ar, v::mul( bi, ai ) ) );
+            v::store( im + i, v::fnmadd( br, ai, v::mul( bi, ar ) ) );
+        }
+        conj_multiply_row<double>( a_re + i, a_im + i, b_re + i, b_im + i, re + i, im + i, n - i );
+    }
+
+    inline void conj_multiply_row( const double* a_re, const double* a_im,
+                                   const double* b_re, const double* b_im,
+                                   complex<double>* out, size_t n )
+    {
+        using v = simd_double;
+        double* out_d = &out->real;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            const v::reg ar = v::load( a_re + i ), ai = v::load( a_im + i );
+            const v::reg br = v::load( b_re + i ), bi = v::load( b_im + i );
+            v::interleave( v::fmadd( br, ar, v::mul( bi, ai ) ),
+                           v::fnmadd( br, ai, v::mul( bi, ar ) ),
+                           out_d + 2*i );
+        }
+        conj_multiply_row<double>( a_re + i, a_im + i, b_re + i, b_im + i, out + i, n - i );
+    }
+
+    inline void abs_sqr_row( const double* re, const double* im, double* out, size_t n )
+    {
+        using v = simd_double;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            const v::reg r = v::load( re + i ), j = v::load( im + i );
+            v::store( out + i, v::fmadd( r, r, v::mul( j, j ) ) );
+        }
+        abs_sqr_row<double>( re + i, im + i, out + i, n - i );
+    }
+
+    inline void abs_row( const double* re, const double* im, double* out, size_t n )
+    {
+        using v = simd_double;
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            const v::reg r = v::load( re + i ), j = v::load( im + i );
+            v::store( out + i, v::sqrt( v::fmadd( r, r, v::mul( j, j ) ) ) );
+        }
+        abs_row<double>( re + i, im + i, out + i, n - i );
+    }
+
+    inline void normalize_row( double* re, double* im, size_t n, double epsilon )
+    {
+        using v = simd_double;
+        const v::reg one = v::set1( 1.0 );
+        const v::reg eps = v::set1( epsilon );
+        size_t i = 0;
+        for ( ; i + v::lanes <= n; i += v::lanes )
+        {
+            const v::reg r = v::load( re + i ), j = v::load( im + i );
+            const v::reg m = v::sqrt( v::fmadd( r, r, v::mul( j, j ) ) );
+            const v::reg s = v::mask_gt( v::div( one, m ), m, eps );
+            v::store( re + i, v::mul( r, s ) );
+            v::store( im + i, v::mul( j, s ) );
+        }
+        normalize_row<double>( re + i, im + i, n - i, epsilon );
+    }
+#endif
+
+}
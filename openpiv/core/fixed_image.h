@@ -0,0 +1,136 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+// local
+#include "core/exception_builder.h"
+#include "core/image_rows.h"
+#include "core/image_type_traits.h"
+#include "core/pixel_types.h"
+#include "core/point.h"
+#include "core/rect.h"
+#include "core/size.h"
+
+namespace openpiv::core {
+
+    /// small image of compile-time size \a W x \a H whose pixels are
+    /// held inline in a std::array, so it never allocates and can be
+    /// returned by value; intended for peak neighbourhoods,
+    /// convolution kernels and the like. Rows are packed.
+    ///
+    /// As for image and image_view, a fixed_image knows its location,
+    /// given by the position of rect(): a neighbourhood copied from an
+    /// image keeps the global position of the area it was copied from,
+    /// \sa fixed_image::copy_from
+    template < typename T, uint32_t W, uint32_t H >
+    class fixed_image
+    {
+        static_assert( W > 0 && H > 0, "fixed_image must not be empty" );
+
+    public:
+        using type = T;
+        using pixel_t = T;
+        using index_t = size_t;
+        using data_t = std::array<T, size_t{W} * H>;
+
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        static constexpr uint32_t fixed_width = W;
+        static constexpr uint32_t fixed_height = H;
+
+        /// image with default pixels at the origin
+        fixed_image() = default;
+
+        /// image filled with \a value at the origin
+        explicit fixed_image( const T& value )
+        {
+            data_.fill( value );
+        }
+
+        /// copy of the W x H area of \a im with bottom-left \a bl, in
+        /// the coordinates of \a im; the copy is located at the global
+        /// position of that area
+        template < typename ImageT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT> > >
+        static fixed_image copy_from( const ImageT& im, const point2<uint32_t>& bl )
+        {
+            if ( bl[0] + W > im.width() || bl[1] + H > im.height() )
+                exception_builder<std::out_of_range>()
+                    << "fixed_image (" << bl << ", " << core::size{ W, H }
+                    << ") not contained within image (" << im.size() << ")";
+
+            fixed_image result;
+            const auto im_bl = im.rect().bottomLeft();
+            result.bl_ = { im_bl[0] + static_cast<int32_t>( bl[0] ), im_bl[1] + static_cast<int32_t>( bl[1] ) };
+            for ( uint32_t h=0; h<H; ++h )
+                std::copy_n( im.line( bl[1] + h ) + bl[0], W, result.line( h ) );
+
+            return result;
+        }
+
+        inline bool operator==( const fixed_image& rhs ) const { return data_ == rhs.data_; }
+        inline bool operator!=( const fixed_image& rhs ) const { return !operator==( rhs ); }
+
+        /// pixel accessors
+        inline constexpr T& operator[]( size_t i ) { return data_[i]; }
+        inline constexpr const T& operator[]( size_t i ) const { return data_[i]; }
+        inline constexpr T& operator[]( const point2<uint32_t>& xy ) { return data_[ size_t{xy[1]} * W + xy[0] ]; }
+        inline constexpr const T& operator[]( const point2<uint32_t>& xy ) const { return data_[ size_t{xy[1]} * W + xy[0] ]; }
+
+        /// raw data accessors
+        inline constexpr T* data() { return data_.data(); }
+        inline constexpr const T* data() const { return data_.data(); }
+        inline constexpr T* line( size_t i ) { return data_.data() + i * W; }
+        inline constexpr const T* line( size_t i ) const { return data_.data() + i * W; }
+
+        /// iterators
+        inline constexpr iterator begin() { return data(); }
+        inline constexpr iterator end() { return data() + pixel_count(); }
+        inline constexpr const_iterator begin() const { return data(); }
+        inline constexpr const_iterator end() const { return data() + pixel_count(); }
+
+        /// rows of contiguous pixels; \sa row_range
+        row_range<T> rows() { return { data(), W, H, W }; }
+        row_range<const T> rows() const { return { data(), W, H, W }; }
+
+        /// geometry accessors
+        inline constexpr uint32_t width() const { return W; }
+        inline constexpr uint32_t height() const { return H; }
+        inline constexpr core::size size() const { return { W, H }; }
+        inline constexpr index_t pixel_count() const { return size_t{W} * H; }
+        inline core::rect rect() const { return { bl_, size() }; }
+
+        /// move the image to bottom-left \a bl
+        inline void set_position( const core::rect::point_t& bl ) { bl_ = bl; }
+
+        /// layout accessors; rows are always packed
+        inline constexpr uint32_t pitch() const { return W; }
+        inline constexpr bool is_packed() const { return true; }
+
+    private:
+        data_t data_{};
+        core::rect::point_t bl_;
+    };
+
+    template < typename T, uint32_t W, uint32_t H >
+    struct is_imagetype< fixed_image<T, W, H> > : std::true_type
+    {};
+
+    /// ostream operator
+    template < typename T, uint32_t W, uint32_t H >
+    std::ostream& operator<<( std::ostream& os, const fixed_image<T, W, H>& p )
+    {
+        os << "fixed_image<" << pixeltype_name<T>() << ">[" << p.rect() << "]";
+
+        return os;
+    }
+
+}
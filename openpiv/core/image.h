@@ -2,9 +2,13 @@
 #pragma once
 
 // std
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <tuple>
 #include <typeinfo>
 #include <type_traits>
@@ -12,7 +16,11 @@
 #include <vector>
 
 // local
+#include "core/aligned_allocator.h"
+#include "core/detail/pixel_conversion.h"
 #include "core/image_expression.h"
+#include "core/image_rows.h"
+#include "core/parallel.h"
 #include "core/image_type_traits.h"
 #include "core/pixel_types.h"
 #include "core/point.h"
@@ -23,8 +31,101 @@
 
 namespace openpiv::core {
 
-/// basic 2-dimensional image; data is stored as a
-/// contiguous array of type T
+/// row layout of image storage
+enum class image_layout
+{
+    packed,  ///< rows are contiguous i.e. the pitch is the width
+    aligned  ///< rows start on 64-byte boundaries and are padded to
+             ///< avoid power-of-two strides
+};
+
+template < typename T >
+class const_wrapped_image;
+
+namespace detail {
+
+    /// iterates over the pixels of an image in row order, skipping any
+    /// padding at the end of each row
+    template < typename T >
+    class pixel_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        pixel_iterator() = default;
+        pixel_iterator( T* data, size_t width, size_t pitch, difference_type i )
+            : data_( data ), width_( width ), pitch_( pitch ), i_( i )
+        {}
+
+        /// iterator -> const_iterator
+        template < typename U,
+                   typename = std::enable_if_t< std::is_same_v< const U, T > > >
+        pixel_iterator( const pixel_iterator<U>& rhs )
+            : data_( rhs.data_ ), width_( rhs.width_ ), pitch_( rhs.pitch_ ), i_( rhs.i_ )
+        {}
+
+        inline reference operator*() const { return *address( i_ ); }
+        inline pointer operator->() const { return address( i_ ); }
+        inline reference operator[]( difference_type n ) const { return *address( i_ + n ); }
+
+        inline pixel_iterator& operator++() { ++i_; return *this; }
+        inline pixel_iterator operator++(int) { pixel_iterator result = *this; ++i_; return result; }
+        inline pixel_iterator& operator--() { --i_; return *this; }
+        inline pixel_iterator operator--(int) { pixel_iterator result = *this; --i_; return result; }
+        inline pixel_iterator& operator+=( difference_type n ) { i_ += n; return *this; }
+        inline pixel_iterator& operator-=( difference_type n ) { i_ -= n; return *this; }
+        inline pixel_iterator operator+( difference_type n ) const { pixel_iterator result = *this; return result += n; }
+        inline pixel_iterator operator-( difference_type n ) const { pixel_iterator result = *this; return result -= n; }
+        inline friend pixel_iterator operator+( difference_type n, const pixel_iterator& it ) { return it + n; }
+        inline difference_type operator-( const pixel_iterator& rhs ) const { return i_ - rhs.i_; }
+
+        inline bool operator==( const pixel_iterator& rhs ) const { return data_ == rhs.data_ && i_ == rhs.i_; }
+        inline bool operator!=( const pixel_iterator& rhs ) const { return !operator==( rhs ); }
+        inline bool operator<( const pixel_iterator& rhs ) const { return i_ < rhs.i_; }
+        inline bool operator>( const pixel_iterator& rhs ) const { return i_ > rhs.i_; }
+        inline bool operator<=( const pixel_iterator& rhs ) const { return i_ <= rhs.i_; }
+        inline bool operator>=( const pixel_iterator& rhs ) const { return i_ >= rhs.i_; }
+
+    private:
+        template < typename U > friend class pixel_iterator;
+
+        inline T* address( difference_type i ) const
+        {
+            if ( width_ == pitch_ )
+                return data_ + i;
+
+            return data_ + ( i / width_ ) * pitch_ + i % width_;
+        }
+
+        T* data_ = nullptr;
+        size_t width_ = 0;
+        size_t pitch_ = 0;
+        difference_type i_ = 0;
+    };
+
+}
+
+/// basic 2-dimensional image; data is stored as an array of type T
+/// with rows pitch() pixels apart; by default rows are packed i.e.
+/// the pitch is the width, but an image_layout::aligned image
+/// starts each row on a 64-byte boundary and avoids power-of-two
+/// strides, which alias cache sets during column passes.
+///
+/// Storage is always 64-byte aligned. Linear pixel indices and
+/// iterators are over pixels only, skipping any row padding.
+///
+/// An image may instead wrap memory it does not own, e.g. a frame in
+/// shared memory or a mapped file, \sa wrap(); such an image is
+/// accepted wherever an image is, without copying.
+///
+/// Copies of an image are deep unless it has shared storage, \sa
+/// share(): copies of a shared image share its pixels until one of
+/// them is modified ("copy on write"), so that e.g. a frame can be
+/// handed to another pipeline stage or thread in constant time.
 template < typename T >
 class image
 {
@@ -32,43 +133,109 @@ public:
     using type = T;
     using pixel_t = T;
     using index_t = size_t;
-    using data_t = typename std::vector<T>;
+    using allocator_type = aligned_allocator<T, 64>;
+    using data_t = typename std::vector<T, allocator_type>;
 
-    using iterator = typename data_t::iterator;
-    using const_iterator = typename data_t::const_iterator;
-    using reverse_iterator = typename data_t::reverse_iterator;
-    using const_reverse_iterator = typename data_t::const_reverse_iterator;
+    using iterator = detail::pixel_iterator<T>;
+    using const_iterator = detail::pixel_iterator<const T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// alignment of storage and, for aligned images, of rows
+    static constexpr size_t alignment = 64;
+
+    /// minimum number of pixels per thread when evaluating expressions
+    static constexpr size_t parallel_pixels = size_t{1} << 18;
 
     // ctor
     image() = default;
-    image( const image& ) = default;
-    image( image&& ) = default;
+
+    /// move; \a rhs is left empty
+    image( image&& rhs )
+        : r_( rhs.r_ )
+        , layout_( rhs.layout_ )
+        , pitch_( rhs.pitch_ )
+        , data_( std::move( rhs.data_ ) )
+        , shared_( std::move( rhs.shared_ ) )
+        , pixels_( ( rhs.wrapped_ || shared_ ) ? rhs.pixels_ : data_.data() )
+        , wrapped_( rhs.wrapped_ )
+    {
+        rhs.make_empty();
+    }
+
+    /// copy; a copy of a wrapped image owns its pixels
+    image( const image& rhs )
+    {
+        *this = rhs;
+    }
 
     /// empty image
     image( uint32_t w, uint32_t h )
         : image( w, h, T{} )
     {}
-    image( const core::size& s )
-        : image( s, T{} )
+    image( const core::size& s, image_layout layout = image_layout::packed )
+        : image( s, T{}, layout )
     {}
-    image( const core::rect& r )
-        : image( r, T{} )
+    image( const core::rect& r, image_layout layout = image_layout::packed )
+        : image( r, T{}, layout )
     {}
 
     /// image with default value
     image( uint32_t w, uint32_t h, T value )
-        : r_( rect::from_size( {w, h} ) )
-        , data_( w*h, value )
+        : image( core::size{ w, h }, value )
+    {}
+    image( const core::size& s, T value, image_layout layout = image_layout::packed )
+        : image( rect::from_size(s), value, layout )
+    {}
+    image( const core::rect& r, T value, image_layout layout = image_layout::packed )
+        : image( r, value, layout, allocator_type{} )
     {}
-    image( const core::size& s, T value )
-        : r_( rect::from_size(s) )
-        , data_( s.area(), value )
+
+    /// image whose storage is obtained from \a alloc, e.g. from a
+    /// std::pmr::memory_resource; \sa default_image_resource()
+    image( const core::size& s, image_layout layout, const allocator_type& alloc )
+        : image( rect::from_size(s), T{}, layout, alloc )
     {}
-    image( const core::rect& r, T value )
+    image( const core::rect& r, T value, image_layout layout, const allocator_type& alloc )
         : r_( r )
-        , data_( r.area(), value )
+        , layout_( layout )
+        , pitch_( pitch_for( r.width(), layout ) )
+        , data_( static_cast<size_t>( pitch_ ) * r.height(), value, alloc )
+        , pixels_( data_.data() )
     {}
 
+    /// \returns an image of size \a s over \a data, with rows \a pitch
+    /// pixels apart (by default \a s.width()); the image does not
+    /// take ownership and \a data must outlive it and any views of
+    /// it. Pixels written through the image are written to \a data.
+    ///
+    /// Copies of a wrapped image own their pixels; resizing a wrapped
+    /// image to a different size detaches it from \a data.
+    static image wrap( T* data, const core::size& s, uint32_t pitch = 0 )
+    {
+        if ( pitch == 0 )
+            pitch = s.width();
+        if ( pitch < s.width() )
+            exception_builder<std::invalid_argument>()
+                << "pitch (" << pitch << ") less than width (" << s.width() << ")";
+        if ( !data && s.area() > 0 )
+            exception_builder<std::invalid_argument>() << "cannot wrap null data of size " << s;
+
+        image result;
+        result.r_ = rect::from_size( s );
+        result.pitch_ = pitch;
+        result.pixels_ = data;
+        result.wrapped_ = true;
+        return result;
+    }
+
+    /// \returns a read-only image over read-only \a data, which gives
+    /// only const access to its pixels; \sa wrap( T*, ... )
+    static const_wrapped_image<T> wrap( const T* data, const core::size& s, uint32_t pitch = 0 )
+    {
+        return const_wrapped_image<T>{ wrap( const_cast<T*>( data ), s, pitch ) };
+    }
+
     /// conversion from another similar image; expensive!
     template < template<typename> class ImageT,
                typename ContainedT,
@@ -78,7 +245,9 @@ public:
                >
     explicit image( const ImageT<ContainedT>& p )
         : r_( p.rect() )
+        , pitch_( p.width() )
         , data_( p.pixel_count() )
+        , pixels_( data_.data() )
     {
         *this = p;
     }
@@ -105,23 +274,105 @@ public:
             return;
 
         r_ = core::rect( r_.bottomLeft(), s );
-        data_.resize( pixel_count() );
+        pitch_ = pitch_for( s.width(), layout_ );
+        if ( shared_ )
+            shared_ = std::make_shared<data_t>( static_cast<size_t>( pitch_ ) * s.height(), T{}, shared_->get_allocator() );
+        else
+            data_.resize( static_cast<size_t>( pitch_ ) * s.height() );
+        pixels_ = shared_ ? shared_->data() : data_.data();
+        wrapped_ = false;
+    }
+
+    /// switch to shared storage: copies of this image, and copies of
+    /// those, then share its pixels rather than copying them. An
+    /// image whose pixels are shared takes its own copy of them when
+    /// it is next modified, i.e. on non-const access to its pixels
+    /// (data(), line(), operator[], iterators, rows()) or assignment
+    /// to it; pointers obtained before the image was copied still
+    /// refer to the shared pixels and must not be written through.
+    ///
+    /// As for std::shared_ptr, images sharing pixels may be used from
+    /// different threads, but a single image must not be modified
+    /// while it is being copied. A wrapped image first takes a copy
+    /// of the memory it wraps.
+    ///
+    /// \returns *this
+    image& share()
+    {
+        if ( shared_ )
+            return *this;
+
+        if ( wrapped_ )
+            *this = image( *this );
+
+        shared_ = std::make_shared<data_t>( std::move( data_ ) );
+        data_ = data_t( shared_->get_allocator() );
+        pixels_ = shared_->data();
+        return *this;
     }
 
+    /// \returns true if the image has shared storage, \sa share()
+    inline bool is_shared() const { return static_cast<bool>( shared_ ); }
+
+    /// \returns the number of images sharing the pixels of this one,
+    /// including this one; 1 if the storage isn't shared
+    inline long share_count() const { return shared_ ? shared_.use_count() : 1; }
+
 
     /// assignment
     image& operator=(const image& rhs)
     {
+        if ( this == &rhs )
+            return *this;
+
         r_ = rhs.r_;
-        data_ = rhs.data_;
+        layout_ = rhs.layout_;
+        if ( rhs.shared_ )
+        {
+            pitch_ = rhs.pitch_;
+            shared_ = rhs.shared_;
+            data_ = data_t( shared_->get_allocator() );
+            pixels_ = rhs.pixels_;
+            wrapped_ = false;
+            return *this;
+        }
+
+        shared_.reset();
+        if ( !rhs.wrapped_ )
+        {
+            pitch_ = rhs.pitch_;
+            data_ = rhs.data_;
+            pixels_ = data_.data();
+            wrapped_ = false;
+            return *this;
+        }
+
+        // wrapped rows may be any distance apart
+        pitch_ = pitch_for( width(), layout_ );
+        data_.resize( static_cast<size_t>( pitch_ ) * height() );
+        pixels_ = data_.data();
+        wrapped_ = false;
+        for ( uint32_t h=0; h<height(); ++h )
+            std::copy( rhs.line(h), rhs.line(h) + width(), line(h) );
+
         return *this;
     }
 
     /// move assignment
     image& operator=(image&& rhs)
     {
-        data_ = std::move(rhs.data_);
-        r_    = std::move(rhs.r_);
+        if ( this == &rhs )
+            return *this;
+
+        data_    = std::move(rhs.data_);
+        shared_  = std::move(rhs.shared_);
+        r_       = std::move(rhs.r_);
+        layout_  = rhs.layout_;
+        pitch_   = rhs.pitch_;
+        wrapped_ = rhs.wrapped_;
+        pixels_  = ( wrapped_ || shared_ ) ? rhs.pixels_ : data_.data();
+
+        rhs.make_empty();
 
         return *this;
     }
@@ -136,68 +387,123 @@ public:
     image& operator=( const ImageT<ContainedT>& p )
     {
         resize( p.size() );
-
-        // no alternative but to iterate
-        for ( index_t i=0; i<p.pixel_count(); ++i )
-            convert( p[i], data_[i] );
+        detach();
+
+        // converted row by row; common pixel type pairs have
+        // vectorized converters, see detail::convert_row
+        const uint32_t w = width();
+        const bool stream = pixel_count() * sizeof(T) >= detail::streaming_store_bytes;
+        parallel_for_blocks(
+            height(),
+            [this, &p, w, stream]( size_t first, size_t last )
+            {
+                for ( size_t h=first; h<last; ++h )
+                    detail::convert_row( p.line( h ), pixels_ + h*pitch_, w, stream );
+            },
+            std::max<size_t>( 1, parallel_pixels / std::max<uint32_t>( w, 1 ) ) );
 
         return *this;
     }
 
+    /// evaluate an expression; this is done row by row over
+    /// contiguous rows of the leaves, so inner loops vectorize, and
+    /// large images are split across threads by rows
     template <typename E,
               typename = typename std::enable_if_t< is_imageexpression_v<E> > >
     image& operator=(const E& e)
     {
         resize( e.size() );
-        for ( index_t i=0; i<pixel_count(); ++i )
-            data_[i] = e[i];
+        detach();
+        const uint32_t w = width();
+        parallel_for_blocks(
+            height(),
+            [this, &e, w]( size_t first, size_t last )
+            {
+                for ( size_t h=first; h<last; ++h )
+                {
+                    const auto row = e.row( h );
+                    T* out = pixels_ + h*pitch_;
+                    for ( uint32_t x=0; x<w; ++x )
+                        out[x] = row[x];
+                }
+            },
+            std::max<size_t>( 1, parallel_pixels / std::max<uint32_t>( w, 1 ) ) );
 
         return *this;
     }
 
-    /// equality
+    /// equality; compares pixels but not layout
     inline bool operator==(const image& rhs) const
     {
-        return
-            r_ == rhs.r_ &&
-            data_ == rhs.data_;
+        if ( r_ != rhs.r_ )
+            return false;
+
+        for ( uint32_t h=0; h<height(); ++h )
+            if ( !std::equal( line(h), line(h) + width(), rhs.line(h) ) )
+                return false;
+
+        return true;
     }
     inline bool operator!=(const image& rhs) const { return !operator==(rhs); }
 
-    /// pixel accessor
-    inline T& operator[](size_t i) { return data_[i]; }
-    inline const T& operator[](size_t i) const { return const_cast<image*>(this)->operator[](i); }
+    /// pixel accessor; non-const access to shared pixels takes a
+    /// copy of them, \sa share()
+    inline const T& operator[](size_t i) const
+    {
+        if ( is_packed() )
+            return pixels_[i];
+
+        return pixels_[ (i / width()) * pitch_ + i % width() ];
+    }
+    inline T& operator[](size_t i)
+    {
+        detach();
+        return const_cast<T&>( std::as_const(*this)[i] );
+    }
 
     /// pixel accessor by point
-    inline T& operator[]( const point2<uint32_t>& xy ) { return data_[xy[1]*r_.width() + xy[0]]; }
-    inline const T& operator[]( const point2<uint32_t>& xy ) const
+    inline const T& operator[]( const point2<uint32_t>& xy ) const { return pixels_[xy[1]*pitch_ + xy[0]]; }
+    inline T& operator[]( const point2<uint32_t>& xy )
     {
-        return const_cast<image*>(this)->operator[](xy);
+        detach();
+        return pixels_[xy[1]*pitch_ + xy[0]];
     }
 
-    /// raw data accessor
-    inline T* data() { return &data_[0]; }
-    inline const T* data() const { return const_cast<image*>(this)->data(); }
+    /// raw data accessor; rows are pitch() pixels apart
+    inline const T* data() const { return pixels_; }
+    inline T* data()
+    {
+        detach();
+        return pixels_;
+    }
 
     /// raw data by line
-    inline T* line( size_t i )
+    inline const T* line( size_t i ) const
     {
         if (i>r_.height())
             exception_builder<std::range_error>() << "line out of range (" << i << ", max is: " << r_.height() << ")";
 
-        return &data_[i*r_.width()];
+        return pixels_ + i*pitch_;
+    }
+    inline T* line( size_t i )
+    {
+        detach();
+        return const_cast<T*>( std::as_const(*this).line(i) );
     }
-    inline const T* line( size_t i ) const { return const_cast<image*>(this)->line(i); }
 
     /// iterators
-    iterator begin() { return std::begin( data_ ); }
-    iterator end() { return std::end( data_ ); }
-    const_iterator begin() const { return std::begin( data_ ); }
-    const_iterator end() const { return std::end( data_ ); }
-    reverse_iterator rbegin() { return std::rbegin( data_ ); }
-    reverse_iterator rend() { return std::rend( data_ ); }
-    const_reverse_iterator rbegin() const { return std::rbegin( data_ ); }
-    const_reverse_iterator rend() const { return std::rend( data_ ); }
+    iterator begin() { detach(); return { pixels_, width(), pitch_, 0 }; }
+    iterator end() { detach(); return { pixels_, width(), pitch_, static_cast<std::ptrdiff_t>( pixel_count() ) }; }
+    const_iterator begin() const { return { pixels_, width(), pitch_, 0 }; }
+    const_iterator end() const { return { pixels_, width(), pitch_, static_cast<std::ptrdiff_t>( pixel_count() ) }; }
+    reverse_iterator rbegin() { return reverse_iterator( end() ); }
+    reverse_iterator rend() { return reverse_iterator( begin() ); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator( end() ); }
+    const_reverse_iterator rend() const { return const_reverse_iterator( begin() ); }
+
+    /// rows of contiguous pixels; \sa row_range
+    row_range<T> rows() { detach(); return { pixels_, width(), height(), pitch_ }; }
+    row_range<const T> rows() const { return { pixels_, width(), height(), pitch_ }; }
 
     /// geometry accessors
     inline constexpr uint32_t width() const { return r_.width(); }
@@ -206,25 +512,140 @@ public:
     inline constexpr index_t pixel_count() const { return r_.area(); }
     inline constexpr core::rect rect() const { return r_; }
 
+    /// layout accessors; the pitch is the distance between rows in
+    /// pixels
+    inline constexpr image_layout layout() const { return layout_; }
+    inline constexpr uint32_t pitch() const { return pitch_; }
+    inline constexpr bool is_packed() const { return pitch_ == width(); }
+
+    /// \returns true if the image wraps memory it does not own
+    inline constexpr bool is_wrapped() const { return wrapped_; }
+
     // distance between pixels in x and y directions
     inline constexpr std::tuple<size_t, size_t> stride() const
     {
-        return { sizeof(pixel_t), width() * sizeof(pixel_t) };
+        return { sizeof(pixel_t), pitch_ * sizeof(pixel_t) };
     }
 
-    /// swap
+    /// \returns the allocator from which storage is obtained
+    inline allocator_type get_allocator() const { return shared_ ? shared_->get_allocator() : data_.get_allocator(); }
+
+    /// swap; images with different resources swap by copying
     void swap( image& rhs )
     {
+        if ( get_allocator() != rhs.get_allocator() )
+        {
+            image tmp{ std::move( rhs ) };
+            rhs = std::move( *this );
+            *this = std::move( tmp );
+            return;
+        }
+
         std::swap( r_, rhs.r_ );
-        std::swap( data_, rhs.data_ );
+        std::swap( layout_, rhs.layout_ );
+        std::swap( pitch_, rhs.pitch_ );
+        std::swap( pixels_, rhs.pixels_ );
+        std::swap( wrapped_, rhs.wrapped_ );
+        data_.swap( rhs.data_ );
+        shared_.swap( rhs.shared_ );
+    }
+
+    /// \returns the pitch in pixels of a row of \a width pixels with
+    /// \a layout; aligned rows are rounded up to a multiple of 64
+    /// bytes, plus a further 64 bytes if that is a multiple of 4096
+    /// bytes (i.e. a power-of-two stride that maps every row to the
+    /// same cache sets)
+    static constexpr uint32_t pitch_for( uint32_t width, image_layout layout )
+    {
+        if ( layout == image_layout::packed || width == 0 )
+            return width;
+
+        size_t bytes = ( ( width * sizeof(T) + alignment - 1 ) / alignment ) * alignment;
+        if ( bytes % 4096 == 0 )
+            bytes += alignment;
+
+        return static_cast<uint32_t>( ( bytes + sizeof(T) - 1 ) / sizeof(T) );
     }
 
 private:
+    /// give this image its own copy of shared pixels if any other
+    /// image shares them
+    inline void detach()
+    {
+        if ( !shared_ || shared_.use_count() == 1 )
+            return;
+
+        shared_ = std::make_shared<data_t>( *shared_ );
+        pixels_ = shared_->data();
+    }
+
+    /// leave a moved-from image empty so that it can't reach the
+    /// pixels it gave up
+    void make_empty()
+    {
+        data_.clear();
+        shared_.reset();
+        r_ = core::rect{};
+        pitch_ = 0;
+        pixels_ = nullptr;
+        wrapped_ = false;
+    }
+
     core::rect r_;
+    image_layout layout_ = image_layout::packed;
+    uint32_t pitch_ = 0;
     data_t data_;
+    std::shared_ptr<data_t> shared_;   ///< storage of a shared image, \sa share()
+    T* pixels_ = nullptr;   ///< data_, shared_ or wrapped memory
+    bool wrapped_ = false;
 };
 
 
+/// read-only image over memory it does not own, \sa image::wrap(
+/// const T*, ... ); it has only the const accessors of image and
+/// converts to a const image, so it can be passed wherever a const
+/// image is accepted without copying. Copies own their pixels.
+template < typename T >
+class const_wrapped_image
+{
+public:
+    using image_t = image<T>;
+    using pixel_t = typename image_t::pixel_t;
+    using index_t = typename image_t::index_t;
+    using const_iterator = typename image_t::const_iterator;
+
+    const_wrapped_image() = default;
+
+    /// \returns the wrapped image
+    inline const image_t& get() const { return im_; }
+    inline operator const image_t&() const { return im_; }
+
+    inline const T& operator[]( size_t i ) const { return im_[i]; }
+    inline const T& operator[]( const point2<uint32_t>& xy ) const { return im_[xy]; }
+    inline const T* data() const { return im_.data(); }
+    inline const T* line( size_t i ) const { return im_.line( i ); }
+    const_iterator begin() const { return im_.begin(); }
+    const_iterator end() const { return im_.end(); }
+
+    inline uint32_t width() const { return im_.width(); }
+    inline uint32_t height() const { return im_.height(); }
+    inline core::size size() const { return im_.size(); }
+    inline index_t pixel_count() const { return im_.pixel_count(); }
+    inline core::rect rect() const { return im_.rect(); }
+    inline uint32_t pitch() const { return im_.pitch(); }
+    inline bool is_packed() const { return im_.is_packed(); }
+    inline bool is_wrapped() const { return im_.is_wrapped(); }
+    inline std::tuple<size_t, size_t> stride() const { return im_.stride(); }
+
+private:
+    friend class image<T>;
+    explicit const_wrapped_image( image_t&& im )
+        : im_( std::move( im ) )
+    {}
+
+    image_t im_;
+};
+
 template <typename PixelT>
 void swap( image<PixelT>& lhs, image<PixelT>& rhs )
 {
@@ -0,0 +1,137 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+// local
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/rect.h"
+#include "core/util.h"
+
+namespace openpiv::core {
+
+    /// An aligned copy of a horizontal band of rows of a frame from
+    /// which overlapping windows of a grid row are taken; rather than
+    /// copying each window from the whole frame, which reads every
+    /// frame pixel several times at high overlap from locations
+    /// spread across the frame, the rows of the band are read once and
+    /// windows are then views into (or copies from) a buffer small
+    /// enough to stay in cache.
+    ///
+    /// Consecutive calls to load() for overlapping bands, e.g. for
+    /// successive grid rows, move the shared rows within the band so
+    /// each frame row is read once per pass over the grid. Rows of the
+    /// band are 64-byte aligned (\sa image_layout::aligned).
+    ///
+    /// Rectangles passed to view() and extract() are in the
+    /// coordinates of the frame, as for core::extract. The frame must
+    /// outlive the band.
+    template < typename T >
+    class image_band
+    {
+    public:
+        using pixel_t = T;
+
+        explicit image_band( const image<T>& frame )
+            : frame_( &frame )
+        {}
+
+        /// hold rows [\a bottom, \a bottom + \a height) of the frame
+        /// \returns the band
+        const image<T>& load( int32_t bottom, uint32_t height )
+        {
+            const core::rect r{ { 0, bottom }, { frame_->width(), height } };
+            if ( !rect::from_size( frame_->size() ).contains( r ) )
+                exception_builder<std::out_of_range>()
+                    << "band (" << r << ") not contained within image (" << frame_->rect() << ")";
+
+            if ( r == rect_ )
+                return band_;
+
+            // rows already held are moved within the band rather than
+            // read again; this is done in place unless the size of the
+            // band changes, when they're copied to new storage as
+            // image::resize() doesn't keep pixels
+            const int32_t width = r.width();
+            const int32_t first_held = std::max( bottom, rect_.bottom() );
+            const int32_t last_held = std::min( r.top(), rect_.top() );
+            const bool overlaps = first_held < last_held && r.width() == rect_.width();
+            const size_t pitch = image<T>::pitch_for( width, image_layout::aligned );
+            const size_t held = overlaps ? ( last_held - first_held ) * pitch : 0;
+            const size_t from = overlaps ? ( first_held - rect_.bottom() ) * pitch : 0;
+            const size_t to = overlaps ? ( first_held - bottom ) * pitch : 0;
+            if ( r.size() == band_.size() )
+                std::memmove( band_.data() + to, band_.data() + from, held * sizeof(T) );
+            else
+            {
+                image<T> resized{ r.size(), image_layout::aligned };
+                typed_memcpy<T>( resized.data() + to, std::as_const( band_ ).data() + from, held );
+                band_.swap( resized );
+            }
+
+            for ( int32_t row = bottom; row < r.top(); ++row )
+            {
+                if ( overlaps && row >= first_held && row < last_held )
+                    continue;
+
+                typed_memcpy<T>( band_.line( row - bottom ), frame_->line( row ), width );
+                ++rows_read_;
+            }
+
+            rect_ = r;
+            return band_;
+        }
+
+        /// \returns the band currently held; the band is located at the
+        /// origin, \sa rect() for its location in the frame
+        inline const image<T>& band() const { return band_; }
+
+        /// \returns the location of the band in the frame
+        inline const core::rect& rect() const { return rect_; }
+
+        /// \returns the number of frame rows read so far
+        inline size_t rows_read() const { return rows_read_; }
+
+        /// \returns a view of \a r, which must lie within the band; the
+        /// view is relative to the band
+        const image_view<T> view( const core::rect& r ) const
+        {
+            return create_image_view( band_, local( r ) );
+        }
+
+        /// \returns a copy of \a r, which must lie within the band; the
+        /// copy keeps \a r as its location
+        image<T> extract( const core::rect& r ) const
+        {
+            const auto l = local( r );
+            image<T> result{ r };
+            for ( uint32_t h = 0; h < r.height(); ++h )
+                typed_memcpy<T>( result.line(h), band_.line( l.bottom() + h ) + l.left(), r.width() );
+
+            return result;
+        }
+
+    private:
+        core::rect local( const core::rect& r ) const
+        {
+            if ( !rect_.contains( r ) )
+                exception_builder<std::out_of_range>()
+                    << "rect (" << r << ") not contained within band (" << rect_ << ")";
+
+            return { { r.left(), r.bottom() - rect_.bottom() }, r.size() };
+        }
+
+        const image<T>* frame_;
+        image<T> band_{ core::size{}, image_layout::aligned };
+        core::rect rect_;
+        size_t rows_read_ = 0;
+    };
+
+}
@@ -16,6 +16,35 @@ namespace openpiv::core {
 template < typename ContainedT > class image_view;
 template < typename ContainedT > class image;
 
+namespace detail {
+
+    /// a row of an image as an expression leaf
+    template <typename T>
+    struct pointer_row
+    {
+        const T* p;
+        inline constexpr T operator[](size_t i) const { return p[i]; }
+    };
+
+    /// a row of a binary expression
+    template <typename Op, typename LeftRow, typename RightRow>
+    struct binary_row
+    {
+        LeftRow l;
+        RightRow r;
+        inline constexpr auto operator[](size_t i) const { return Op::apply(l[i], r[i]); }
+    };
+
+    /// a row of a unary expression
+    template <typename Op, typename Row>
+    struct unary_row
+    {
+        Row e;
+        inline constexpr auto operator[](size_t i) const { return Op::apply(e[i]); }
+    };
+
+}
+
 
 /// wrapper around a constant to adhere to requirements of
 /// ImageExpression
@@ -42,6 +71,12 @@ public:
         return t_;
     }
 
+    /// \returns row \a h of the expression, indexed by column
+    inline constexpr const const_image_expression_node& row(uint32_t) const
+    {
+        return *this;
+    }
+
     inline constexpr core::size size() const
     {
         return size_;
@@ -60,7 +95,7 @@ template <template <typename> class ImageT,
 class image_interface_expression_node
 {
 public:
-    using type = T;
+    using type = ContainedT;
 
     image_interface_expression_node() = default;
     image_interface_expression_node(const image_interface_expression_node&) = default;
@@ -74,6 +109,12 @@ public:
         return im_[i];
     }
 
+    /// \returns row \a h of the expression, indexed by column
+    inline detail::pointer_row<ContainedT> row(uint32_t h) const
+    {
+        return { im_.line(h) };
+    }
+
     inline constexpr core::size size() const
     {
         return im_.size();
@@ -115,6 +156,14 @@ public:
         return Op::apply(le()[index], re()[index]);
     }
 
+    /// \returns row \a h of the expression, indexed by column; rows
+    /// of image leaves are contiguous, so evaluating a row is a
+    /// simple loop that the compiler can vectorize
+    inline auto row(uint32_t h) const
+    {
+        return detail::binary_row<Op, decltype(le_.row(h)), decltype(re_.row(h))>{ le_.row(h), re_.row(h) };
+    }
+
     inline constexpr core::size size() const
     {
         return le_.size();
@@ -155,6 +204,12 @@ public:
         return Op::apply(expr()[index]);
     }
 
+    /// \returns row \a h of the expression, indexed by column
+    inline auto row(uint32_t h) const
+    {
+        return detail::unary_row<Op, decltype(expr_.row(h))>{ expr_.row(h) };
+    }
+
     inline constexpr core::size size() const
     {
         return expr_.size();
@@ -0,0 +1,169 @@
+
+#include "core/image_memory.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <new>
+
+namespace openpiv::core {
+
+namespace {
+
+    constexpr size_t block_alignment = 64;
+    constexpr size_t min_block_bits = 8;   // 256 bytes
+    constexpr size_t max_block_bits = 22;  // 4 MiB
+    constexpr size_t class_count = max_block_bits - min_block_bits + 1;
+    constexpr size_t max_cached_bytes = size_t{16} << 20;
+
+    constexpr size_t block_size( size_t c )
+    {
+        return size_t{1} << ( c + min_block_bits );
+    }
+
+    size_t size_class( size_t bytes )
+    {
+        size_t bits = min_block_bits;
+        while ( ( size_t{1} << bits ) < bytes )
+            ++bits;
+        return bits - min_block_bits;
+    }
+
+    bool is_pooled( size_t bytes, size_t alignment )
+    {
+        return bytes <= block_size( class_count - 1 ) && alignment <= block_alignment;
+    }
+
+    void* allocate_block( size_t bytes, size_t alignment )
+    {
+        return ::operator new( bytes, std::align_val_t{ std::max( alignment, block_alignment ) } );
+    }
+
+    void deallocate_block( void* p, size_t alignment )
+    {
+        ::operator delete( p, std::align_val_t{ std::max( alignment, block_alignment ) } );
+    }
+
+    // set when the calling thread's cache is destroyed; images freed
+    // after that, e.g. statics destroyed at exit, bypass the cache
+    thread_local bool cache_destroyed = false;
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct thread_cache
+    {
+        std::array<free_block*, class_count> heads{};
+        std::array<size_t, class_count> counts{};
+        image_pool_stats stats;
+
+        ~thread_cache()
+        {
+            release();
+            cache_destroyed = true;
+        }
+
+        void release()
+        {
+            for ( size_t c = 0; c < class_count; ++c )
+            {
+                while ( heads[c] )
+                {
+                    free_block* b = heads[c];
+                    heads[c] = b->next;
+                    deallocate_block( b, block_alignment );
+                }
+                counts[c] = 0;
+            }
+            stats.cached_bytes = 0;
+        }
+    };
+
+    thread_cache& cache()
+    {
+        thread_local thread_cache result;
+        return result;
+    }
+
+    class pool_resource final : public std::pmr::memory_resource
+    {
+        void* do_allocate( size_t bytes, size_t alignment ) override
+        {
+            if ( !is_pooled( bytes, alignment ) || cache_destroyed )
+                return allocate_block( bytes, alignment );
+
+            const size_t c = size_class( bytes );
+            thread_cache& tc = cache();
+            if ( free_block* b = tc.heads[c] )
+            {
+                tc.heads[c] = b->next;
+                --tc.counts[c];
+                tc.stats.cached_bytes -= block_size( c );
+                ++tc.stats.hits;
+                return b;
+            }
+
+            ++tc.stats.misses;
+            return allocate_block( block_size( c ), block_alignment );
+        }
+
+        void do_deallocate( void* p, size_t bytes, size_t alignment ) override
+        {
+            if ( !is_pooled( bytes, alignment ) || cache_destroyed )
+                return deallocate_block( p, alignment );
+
+            const size_t c = size_class( bytes );
+            thread_cache& tc = cache();
+            if ( ( tc.counts[c] + 1 ) * block_size( c ) > max_cached_bytes )
+                return deallocate_block( p, block_alignment );
+
+            tc.heads[c] = new ( p ) free_block{ tc.heads[c] };
+            ++tc.counts[c];
+            tc.stats.cached_bytes += block_size( c );
+        }
+
+        bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    std::atomic<std::pmr::memory_resource*>& default_resource()
+    {
+        static std::atomic<std::pmr::memory_resource*> result{ image_pool_resource() };
+        return result;
+    }
+
+}
+
+std::pmr::memory_resource* image_pool_resource()
+{
+    static pool_resource result;
+    return &result;
+}
+
+image_pool_stats image_pool_thread_stats()
+{
+    return cache().stats;
+}
+
+void image_pool_release()
+{
+    cache().release();
+}
+
+std::pmr::memory_resource* default_image_resource()
+{
+    return default_resource().load( std::memory_order_acquire );
+}
+
+std::pmr::memory_resource* set_default_image_resource( std::pmr::memory_resource* resource )
+{
+    return default_resource().exchange( resource ? resource : image_pool_resource(),
+                                        std::memory_order_acq_rel );
+}
+
+}
@@ -0,0 +1,47 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <memory_resource>
+
+namespace openpiv::core {
+
+    /// statistics of the image pool for a thread
+    struct image_pool_stats
+    {
+        size_t hits = 0;          ///< allocations served from cached blocks
+        size_t misses = 0;        ///< allocations passed to the global allocator
+        size_t cached_bytes = 0;  ///< size of the blocks currently cached
+    };
+
+    /// \returns the process-wide image pool: a memory resource that
+    /// keeps freed blocks in per-thread free lists by size class
+    /// (powers of two from 256 bytes to 4 MiB), so that steady-state
+    /// allocation of same-sized images such as windows, spectra and
+    /// correlation planes neither calls the global allocator nor
+    /// contends with other threads.
+    ///
+    /// Blocks are cached by the thread that frees them, so images may
+    /// be freed on a different thread from the one that allocated
+    /// them; each thread caches at most 16 MiB per size class and
+    /// releases its cache when it exits. Larger requests go straight
+    /// to the global allocator. All blocks are 64-byte aligned.
+    std::pmr::memory_resource* image_pool_resource();
+
+    /// \returns statistics of the image pool for the calling thread
+    image_pool_stats image_pool_thread_stats();
+
+    /// release the blocks cached by the calling thread
+    void image_pool_release();
+
+    /// \returns the resource used by images created without one;
+    /// initially image_pool_resource()
+    std::pmr::memory_resource* default_image_resource();
+
+    /// set the resource used by images created without one e.g.
+    /// std::pmr::new_delete_resource() to bypass the pool
+    /// \returns the previous resource
+    std::pmr::memory_resource* set_default_image_resource( std::pmr::memory_resource* resource );
+
+}
@@ -0,0 +1,254 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// local
+#include "core/detail/downsample.h"
+#include "core/exception_builder.h"
+#include "core/grid.h"
+#include "core/image.h"
+#include "core/image_type_traits.h"
+#include "core/parallel.h"
+#include "core/pixel_types.h"
+#include "core/point.h"
+#include "core/rect.h"
+#include "core/size.h"
+
+namespace openpiv::core {
+
+    /// coordinates between pyramid levels: level l + 1 is level l
+    /// filtered and decimated by 2, so that pixel x of level l + 1 is
+    /// centred on x * 2 + 0.5 of level l and spans [2x, 2x + 2)
+
+    /// \returns the factor that converts lengths (e.g. displacements)
+    /// at level \a from to lengths at level \a to
+    inline double pyramid_scale( uint32_t from, uint32_t to )
+    {
+        return std::ldexp( 1.0, static_cast<int>( from ) - static_cast<int>( to ) );
+    }
+
+    /// \returns the position at level \a to of the pixel position \a p
+    /// at level \a from
+    inline point2<double> map_to_level( const point2<double>& p, uint32_t from, uint32_t to )
+    {
+        const double s = pyramid_scale( from, to );
+        return { ( p[0] + 0.5 ) * s - 0.5, ( p[1] + 0.5 ) * s - 0.5 };
+    }
+
+    /// \returns the smallest rectangle at level \a to that covers \a r
+    /// at level \a from; mapping to a finer level is exact
+    inline core::rect map_to_level( const core::rect& r, uint32_t from, uint32_t to )
+    {
+        const double s = pyramid_scale( from, to );
+        const auto left   = static_cast<int32_t>( std::floor( r.left() * s ) );
+        const auto bottom = static_cast<int32_t>( std::floor( r.bottom() * s ) );
+        const auto right  = static_cast<int32_t>( std::ceil( r.right() * s ) );
+        const auto top    = static_cast<int32_t>( std::ceil( r.top() * s ) );
+
+        return { { left, bottom },
+                 { static_cast<uint32_t>( right - left ), static_cast<uint32_t>( top - bottom ) } };
+    }
+
+    /// \returns each of \a rects mapped from level \a from to level \a to
+    inline std::vector<core::rect> map_to_level( const std::vector<core::rect>& rects, uint32_t from, uint32_t to )
+    {
+        std::vector<core::rect> result;
+        result.reserve( rects.size() );
+        for ( const auto& r : rects )
+            result.push_back( map_to_level( r, from, to ) );
+
+        return result;
+    }
+
+    /// \returns the size of level \a l of a pyramid with base size \a s;
+    /// odd trailing rows and columns are dropped at each level
+    inline core::size pyramid_level_size( const core::size& s, uint32_t l )
+    {
+        if ( l >= 32 )
+            return {};
+        return { s.width() >> l, s.height() >> l };
+    }
+
+    /// image pyramid for coarse to fine processing: level 0 is the
+    /// base image and each further level is the previous one low pass
+    /// filtered with [1 3 3 1]/8 in each direction and decimated by 2.
+    ///
+    /// Levels are computed on first access (\sa level()) and the
+    /// storage of all levels is kept when a new base is assigned, so
+    /// rebuilding a pyramid of the same size, e.g. for each frame of a
+    /// sequence, doesn't allocate. Level access isn't thread safe.
+    ///
+    /// Use grid() to generate interrogation areas at a level and
+    /// map_to_level() to move them, or positions and displacements
+    /// found in them, to other levels.
+    template < typename PixelT = g_f >
+    class image_pyramid
+    {
+        static_assert( is_real_mono_pixeltype_v<PixelT> && std::is_floating_point_v<typename PixelT::value_t>,
+                       "image_pyramid requires floating point greyscale pixels" );
+
+    public:
+        using pixel_t = PixelT;
+        using value_t = typename PixelT::value_t;
+        using image_t = image<PixelT>;
+
+        /// no more levels than this are built
+        static constexpr uint32_t default_max_levels = 32;
+
+        explicit image_pyramid( uint32_t max_levels = default_max_levels )
+            : max_levels_( std::max<uint32_t>( max_levels, 1 ) )
+        {}
+
+        /// pyramid of \a base
+        template < template<typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       pixeltype_is_convertible_v< ContainedT, PixelT > &&
+                       is_imagetype_v< ImageT<ContainedT> > >
+                   >
+        explicit image_pyramid( const ImageT<ContainedT>& base, uint32_t max_levels = default_max_levels )
+            : image_pyramid( max_levels )
+        {
+            assign( base );
+        }
+
+        /// replace the base with a converted copy of \a base (or a
+        /// reference to it if it is a shared image of pixel_t, \sa
+        /// image::share()); coarser levels are recomputed on access
+        template < template<typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t<
+                       pixeltype_is_convertible_v< ContainedT, PixelT > &&
+                       is_imagetype_v< ImageT<ContainedT> > >
+                   >
+        void assign( const ImageT<ContainedT>& base )
+        {
+            prepare();
+            levels_[0] = base;
+            update_levels();
+        }
+
+        /// replace the base with \a base
+        void assign( image_t&& base )
+        {
+            prepare();
+            levels_[0] = std::move( base );
+            update_levels();
+        }
+
+        /// \returns the number of levels: at most the maximum set on
+        /// construction and only while a level has at least one pixel
+        inline uint32_t levels() const { return levels_count_; }
+        inline uint32_t max_levels() const { return max_levels_; }
+
+        /// \returns the size of level \a l
+        inline core::size level_size( uint32_t l ) const { return pyramid_level_size( base_size(), l ); }
+        inline core::size base_size() const { return levels_.empty() ? core::size{} : levels_[0].size(); }
+
+        /// \returns true if level \a l has been computed since the base
+        /// was assigned
+        inline bool is_computed( uint32_t l ) const { return l < computed_; }
+
+        /// \returns level \a l, computing it and any finer levels that
+        /// haven't been yet
+        const image_t& level( uint32_t l )
+        {
+            if ( l >= levels_count_ )
+                exception_builder<std::out_of_range>() << "pyramid level " << l << " out of range: " << levels_count_;
+
+            for ( ; computed_ <= l; ++computed_ )
+                downsample( levels_[computed_ - 1], levels_[computed_] );
+
+            return levels_[l];
+        }
+        inline const image_t& operator[]( uint32_t l ) { return level( l ); }
+
+        /// \returns a centred cartesian grid of interrogation areas of
+        /// \a interrogation_size at level \a l, \sa generate_cartesian_grid
+        std::vector<core::rect> grid( uint32_t l, const core::size& interrogation_size, double percentage_offset ) const
+        {
+            if ( l >= levels_count_ )
+                exception_builder<std::out_of_range>() << "pyramid level " << l << " out of range: " << levels_count_;
+
+            return generate_cartesian_grid( level_size( l ), interrogation_size, percentage_offset );
+        }
+
+    private:
+        /// make storage for all levels available; existing level images
+        /// keep their allocations
+        void prepare()
+        {
+            if ( levels_.size() < max_levels_ )
+                levels_.resize( max_levels_ );
+            computed_ = 0;
+            levels_count_ = 0;
+        }
+
+        void update_levels()
+        {
+            const core::size s = levels_[0].size();
+            if ( s.area() == 0 )
+                return;
+
+            levels_count_ = 1;
+            while ( levels_count_ < max_levels_ && level_size( levels_count_ ).area() > 0 )
+                ++levels_count_;
+            computed_ = 1;
+        }
+
+        /// \a out is \a in filtered and decimated by 2; rows are
+        /// independent so are computed in parallel
+        static void downsample( const image_t& in, image_t& out )
+        {
+            const uint32_t in_w = in.width();
+            const uint32_t in_h = in.height();
+            out.resize( { in_w / 2, in_h / 2 } );
+
+            const uint32_t out_w = out.width();
+            parallel_for_blocks(
+                out.height(),
+                [&in, &out, in_w, in_h, out_w]( size_t first, size_t last )
+                {
+                    // column sums with a repeated value either side;
+                    // the horizontal pass reads up to 2 * out_w + 4
+                    std::vector<value_t> sum( std::max<size_t>( in_w, 2 * out_w + 2 ) + 2 );
+                    const size_t tail = sum.size() - in_w - 1;
+                    const auto row = [&in, in_h]( int64_t y ) {
+                        return &in.line( std::clamp<int64_t>( y, 0, in_h - 1 ) )->v;
+                    };
+
+                    for ( size_t y=first; y<last; ++y )
+                    {
+                        const int64_t fy = 2 * static_cast<int64_t>( y );
+                        detail::downsample_columns( row( fy - 1 ), row( fy ), row( fy + 1 ), row( fy + 2 ),
+                                                    sum.data(), in_w, tail );
+                        detail::downsample_row( sum.data(), &out.line( y )->v, out_w );
+                    }
+                },
+                std::max<size_t>( 1, image_t::parallel_pixels / std::max<uint32_t>( in_w * 2, 1 ) ) );
+        }
+
+        uint32_t max_levels_ = default_max_levels;
+        uint32_t levels_count_ = 0;
+        uint32_t computed_ = 0;
+        std::vector<image_t> levels_;
+    };
+
+    /// ostream operator
+    template < typename PixelT >
+    std::ostream& operator<<( std::ostream& os, const image_pyramid<PixelT>& p )
+    {
+        os << "image_pyramid<" << pixeltype_name<PixelT>() << ">[" << p.base_size() << ", " << p.levels() << " levels]";
+
+        return os;
+    }
+
+}
@@ -0,0 +1,106 @@
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace openpiv::core {
+
+    /// a row of contiguous pixels
+    template < typename T >
+    class row_span
+    {
+    public:
+        using value_type = std::remove_const_t<T>;
+        using iterator = T*;
+
+        row_span() = default;
+        row_span( T* data, uint32_t width )
+            : data_( data ), width_( width )
+        {}
+
+        inline T* data() const { return data_; }
+        inline uint32_t size() const { return width_; }
+        inline T* begin() const { return data_; }
+        inline T* end() const { return data_ + width_; }
+        inline T& operator[]( size_t i ) const { return data_[i]; }
+
+    private:
+        T* data_ = nullptr;
+        uint32_t width_ = 0;
+    };
+
+    /// the rows of an image or image_view as a range of row_span;
+    /// iterating over rows rather than pixels avoids per-pixel index
+    /// arithmetic and allows the loop over each row to be vectorized
+    /// e.g.
+    ///
+    ///   for ( auto row : im.rows() )
+    ///       for ( auto& p : row )
+    ///           p *= 2;
+    template < typename T >
+    class row_range
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = row_span<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = row_span<T>;
+
+            iterator() = default;
+            iterator( T* first, uint32_t width, size_t pitch, difference_type i )
+                : first_( first ), width_( width ), pitch_( pitch ), i_( i )
+            {}
+
+            inline reference operator*() const { return { first_ + i_ * pitch_, width_ }; }
+            inline reference operator[]( difference_type n ) const { return *( *this + n ); }
+
+            inline iterator& operator++() { ++i_; return *this; }
+            inline iterator operator++(int) { iterator result = *this; ++i_; return result; }
+            inline iterator& operator--() { --i_; return *this; }
+            inline iterator operator--(int) { iterator result = *this; --i_; return result; }
+            inline iterator& operator+=( difference_type n ) { i_ += n; return *this; }
+            inline iterator& operator-=( difference_type n ) { i_ -= n; return *this; }
+            inline iterator operator+( difference_type n ) const { iterator result = *this; return result += n; }
+            inline iterator operator-( difference_type n ) const { iterator result = *this; return result -= n; }
+            inline difference_type operator-( const iterator& rhs ) const { return i_ - rhs.i_; }
+
+            inline bool operator==( const iterator& rhs ) const { return first_ == rhs.first_ && i_ == rhs.i_; }
+            inline bool operator!=( const iterator& rhs ) const { return !operator==( rhs ); }
+            inline bool operator<( const iterator& rhs ) const { return i_ < rhs.i_; }
+
+        private:
+            T* first_ = nullptr;
+            uint32_t width_ = 0;
+            size_t pitch_ = 0;
+            difference_type i_ = 0;
+        };
+
+        row_range() = default;
+
+        /// \a height rows of \a width pixels, \a pitch pixels apart,
+        /// starting at \a first
+        row_range( T* first, uint32_t width, uint32_t height, size_t pitch )
+            : first_( first ), width_( width ), height_( height ), pitch_( pitch )
+        {}
+
+        inline iterator begin() const { return { first_, width_, pitch_, 0 }; }
+        inline iterator end() const { return { first_, width_, pitch_, height_ }; }
+        inline uint32_t size() const { return height_; }
+        inline row_span<T> operator[]( size_t i ) const { return { first_ + i * pitch_, width_ }; }
+
+    private:
+        T* first_ = nullptr;
+        uint32_t width_ = 0;
+        uint32_t height_ = 0;
+        size_t pitch_ = 0;
+    };
+
+}
@@ -8,6 +8,7 @@
 
 // local
 #include "core/exception_builder.h"
+#include "core/fixed_image.h"
 #include "core/image.h"
 #include "core/image_view.h"
 #include "core/image_type_traits.h"
@@ -48,6 +49,36 @@ template < template<typename> class ImageT,
            >
 result_t fit_simple_guassian( const image_view<ContainedT>& );
 
+/// a peak neighbourhood of radius \a Radius, \sa find_fixed_peaks
+template < typename ContainedT, uint32_t Radius >
+using fixed_peak_t = fixed_image< ContainedT, 2*Radius + 1, 2*Radius + 1 >;
+
+template < typename ContainedT, uint32_t Radius >
+using fixed_peaks_t = std::vector< fixed_peak_t<ContainedT, Radius> >;
+
+/// Find highest \a num_peaks peaks in an image as for find_peaks
+/// but return copies of their neighbourhoods of radius \a Radius
+/// e.g.
+///
+///   auto peaks = find_fixed_peaks< 1 >( correlation, 2 );
+///   auto location = fit_simple_gaussian( peaks[0] );
+///
+/// The peaks do not refer to \a im, which need not outlive them, and
+/// only the final \a num_peaks neighbourhoods are copied.
+template < uint32_t Radius,
+           template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT = fixed_peaks_t<ContainedT, Radius>,
+           typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+           >
+ReturnT find_fixed_peaks( const ImageT<ContainedT>& im, uint16_t num_peaks );
+
+/// Fit two one-dimensional Gaussian curves to a 3x3 peak
+template < typename ContainedT,
+           typename result_t = point2<double>
+           >
+result_t fit_simple_gaussian( const fixed_image<ContainedT, 3, 3>& im );
+
 /// apply a function to each pixel; op is of form:
 ///
 /// using index_t = ImageT<ContainedT>::index_t;
@@ -195,6 +226,72 @@ template < template<typename> class ImageT,
            typename  ContainedT >
 image<ContainedT> extract( const ImageT<ContainedT>& im, core::rect r );
 
+/// convolve a greyscale image with a separable kernel: the rows with
+/// \a kx, then the columns with \a ky. Kernels have an odd number of
+/// taps and are centred on each pixel; pixels beyond the edges of the
+/// image repeat the edge pixels.
+///
+/// Filtering is done in single precision, the rows with vectorized
+/// kernels and the columns as rows of the transposed image, in
+/// parallel over bands of rows for large images. Integer pixels are
+/// rounded and clamped to their range.
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT = image< ContainedT >,
+           typename = typename std::enable_if_t<
+               is_imagetype_v<ImageT<ContainedT>> &&
+               is_real_mono_pixeltype_v<ContainedT>
+               >
+           >
+ReturnT convolve_separable( const ImageT<ContainedT>& im,
+                            const std::vector<double>& kx,
+                            const std::vector<double>& ky );
+
+/// \returns a normalized, sampled Gaussian of standard deviation \a
+/// sigma with 2 * \a radius + 1 taps; by default the radius is
+/// ceil( 3 * sigma )
+inline std::vector<double> gaussian_kernel( double sigma, uint32_t radius = 0 );
+
+/// Gaussian blur of standard deviation \a sigma by convolution with
+/// gaussian_kernel( sigma ); the cost grows with sigma, \sa
+/// recursive_gaussian_blur
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT = image< ContainedT >,
+           typename = typename std::enable_if_t<
+               is_imagetype_v<ImageT<ContainedT>> &&
+               is_real_mono_pixeltype_v<ContainedT>
+               >
+           >
+ReturnT gaussian_blur( const ImageT<ContainedT>& im, double sigma );
+
+/// mean over the ( 2 * \a radius + 1 )^2 pixels centred on each pixel,
+/// using running sums so that the cost doesn't depend on \a radius;
+/// edges are handled as for convolve_separable
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT = image< ContainedT >,
+           typename = typename std::enable_if_t<
+               is_imagetype_v<ImageT<ContainedT>> &&
+               is_real_mono_pixeltype_v<ContainedT>
+               >
+           >
+ReturnT box_blur( const ImageT<ContainedT>& im, uint32_t radius );
+
+/// Gaussian blur of standard deviation \a sigma (at least 0.5) by a
+/// recursive (IIR) approximation, so that the cost doesn't depend on
+/// sigma; preferable to gaussian_blur for large sigma. Edges are
+/// handled as for convolve_separable
+template < template<typename> class ImageT,
+           typename ContainedT,
+           typename ReturnT = image< ContainedT >,
+           typename = typename std::enable_if_t<
+               is_imagetype_v<ImageT<ContainedT>> &&
+               is_real_mono_pixeltype_v<ContainedT>
+               >
+           >
+ReturnT recursive_gaussian_blur( const ImageT<ContainedT>& im, double sigma );
+
 }
 
 #include "core/detail/image_utils.impl.h"
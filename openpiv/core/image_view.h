@@ -29,6 +29,10 @@ namespace openpiv::core {
     /// image, and pixel access of the image_view is in local
     /// coordinates
     ///
+    /// Pixel access is bounds-checked only in debug builds (i.e. when
+    /// NDEBUG is not defined); rows() gives contiguous rows for loops
+    /// that should vectorize.
+    ///
     /// image and image_view both know their location - this is
     /// given by the position of the image or image_view rect().
     /// For an image_view, this position is in global coordinates
@@ -80,22 +84,39 @@ namespace openpiv::core {
 
         inline T& operator[](size_t i)
         {
-            if ( i > r_.area() )
-                core::exception_builder<std::out_of_range>() << "index outside of allowed area: " << i << " > " << r_.area();
-
-            const rect::point_t iv_location{ i % r_.width(), i / r_.width() };
-            return im_->operator[]({
-                    r_.left() + iv_location[0],
-                    r_.bottom() + iv_location[1]
-                });
+#ifndef NDEBUG
+            if ( i >= r_.area() )
+                core::exception_builder<std::out_of_range>() << "index outside of allowed area: " << i << " >= " << r_.area();
+#endif
+            const uint32_t w = r_.width();
+            return origin()[ ( i / w ) * im_->pitch() + i % w ];
+        }
+        inline const T& operator[](size_t i) const
+        {
+#ifndef NDEBUG
+            if ( i >= r_.area() )
+                core::exception_builder<std::out_of_range>() << "index outside of allowed area: " << i << " >= " << r_.area();
+#endif
+            const uint32_t w = r_.width();
+            return origin()[ ( i / w ) * im_->pitch() + i % w ];
         }
-        inline const T& operator[](size_t i) const { return const_cast<image_view<T>*>(this)->operator[](i); }
 
         inline T& operator[]( const point2<uint32_t>& xy )
         {
-            return this->operator[](xy[1]*r_.width() + xy[0]);
+#ifndef NDEBUG
+            if ( xy[0] >= r_.width() || xy[1] >= r_.height() )
+                core::exception_builder<std::out_of_range>() << "point outside of allowed area: " << xy << ", " << r_.size();
+#endif
+            return origin()[ xy[1] * im_->pitch() + xy[0] ];
+        }
+        inline const T& operator[]( const point2<uint32_t>& xy ) const
+        {
+#ifndef NDEBUG
+            if ( xy[0] >= r_.width() || xy[1] >= r_.height() )
+                core::exception_builder<std::out_of_range>() << "point outside of allowed area: " << xy << ", " << r_.size();
+#endif
+            return origin()[ xy[1] * im_->pitch() + xy[0] ];
         }
-        inline const T& operator[]( const point2<uint32_t>& xy ) const { return const_cast<image_view<T>*>(this)->operator[](xy); }
 
         inline const T* line(size_t i) const { return im_->line(r_.bottom() + i) + r_.left(); }
         inline T* line(size_t i) { return im_->line(r_.bottom() + i) + r_.left(); }
@@ -112,75 +133,21 @@ namespace openpiv::core {
             };
         }
 
-        class iterator
-        {
-        public:
-            using iterator_category = std::bidirectional_iterator_tag;
-            using value_type = pixel_t;
-            using difference_type = typename image<T>::data_t::difference_type;
-            using pointer = pixel_t*;
-            using reference = pixel_t&;
-
-            explicit iterator( image_view& iv, index_t i = 0 ) : iv_( iv ), i_( i ) {}
-            iterator& operator++() { ++i_; return *this; }
-            iterator operator++(int) { iterator result = *this; operator++(); return result; }
-            iterator& operator--() { --i_; return *this; }
-            iterator operator--(int) { iterator result = *this; operator--(); return result; }
-            bool operator==(const iterator& rhs) const { return iv_ == rhs.iv_ && i_ == rhs.i_; }
-            bool operator!=(const iterator& rhs) const { return !operator==(rhs); }
-
-            pixel_t& operator*()
-            {
-                if ( i_ < 0 || i_ >= iv_.pixel_count() )
-                    core::exception_builder< std::out_of_range >()
-                        << "attempting to dereference out of range iterator: "
-                        << i_ << ", " << iv_.pixel_count();
-
-                return iv_[ {i_ % iv_.width(), i_ / iv_.width()} ];
-            }
-
-        private:
-            image_view& iv_;
-            index_t i_ = {};
-        };
-
-        class const_iterator
-        {
-        public:
-            using iterator_category = std::bidirectional_iterator_tag;
-            using value_type = pixel_t;
-            using difference_type = typename image<T>::data_t::difference_type;
-            using pointer = pixel_t*;
-            using reference = pixel_t&;
-
-            explicit const_iterator( const image_view& iv, index_t i = 0 ) : iv_( iv ), i_( i ) {}
-            const_iterator& operator++() { ++i_; return *this; }
-            const_iterator operator++(int) { const_iterator result = *this; operator++(); return result; }
-            const_iterator& operator--() { --i_; return *this; }
-            const_iterator operator--(int) { const_iterator result = *this; operator--(); return result; }
-            bool operator==(const const_iterator& rhs) const { return iv_ == rhs.iv_ && i_ == rhs.i_; }
-            bool operator!=(const const_iterator& rhs) const { return !operator==(rhs); }
-
-            const pixel_t& operator*()
-            {
-                if ( i_ < 0 || i_ >= iv_.pixel_count() )
-                    core::exception_builder< std::out_of_range >()
-                        << "attempting to dereference out of range iterator: "
-                        << i_ << ", " << iv_.pixel_count();
-
-                return iv_[ {i_ % iv_.width(), i_ / iv_.width()} ];
-            }
-
-        private:
-            const image_view& iv_;
-            index_t i_ = {};
-        };
+        using iterator = detail::pixel_iterator<T>;
+        using const_iterator = detail::pixel_iterator<const T>;
 
         /// iterators
-        iterator begin() { return iterator( *this ); }
-        iterator end() { return iterator( *this, pixel_count() ); }
-        const_iterator begin() const { return const_iterator( *this ); }
-        const_iterator end() const { return const_iterator( *this, pixel_count() ); }
+        iterator begin() { return { origin(), width(), pitch(), 0 }; }
+        iterator end() { return { origin(), width(), pitch(), static_cast<std::ptrdiff_t>( pixel_count() ) }; }
+        const_iterator begin() const { return { origin(), width(), pitch(), 0 }; }
+        const_iterator end() const { return { origin(), width(), pitch(), static_cast<std::ptrdiff_t>( pixel_count() ) }; }
+
+        /// rows of contiguous pixels; \sa row_range
+        row_range<T> rows() { return { origin(), width(), height(), pitch() }; }
+        row_range<const T> rows() const { return { origin(), width(), height(), pitch() }; }
+
+        /// distance between rows in pixels
+        inline uint32_t pitch() const { return im_ ? im_->pitch() : 0; }
 
         std::tuple<size_t, size_t> stride() const
         {
@@ -193,6 +160,23 @@ namespace openpiv::core {
         const image<T>& underlying() const { return *im_; }
 
     private:
+        /// \returns the first pixel of the view; const access doesn't
+        /// copy the pixels of a shared image (\sa image::share)
+        inline T* origin()
+        {
+            if ( !im_ )
+                return nullptr;
+
+            return im_->data() + static_cast<size_t>( r_.bottom() ) * im_->pitch() + r_.left();
+        }
+        inline const T* origin() const
+        {
+            if ( !im_ )
+                return nullptr;
+
+            return im_->data() + static_cast<size_t>( r_.bottom() ) * im_->pitch() + r_.left();
+        }
+
         image_view( image<T>& im, const core::rect& r )
             : im_(&im)
             , r_(r)
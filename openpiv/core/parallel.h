@@ -0,0 +1,77 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace openpiv::core {
+
+    /// split the range [0, \a count) into contiguous blocks and call
+    /// \a f for each block:
+    ///
+    /// void f( size_t begin, size_t end )
+    ///
+    /// blocks are processed concurrently using up to
+    /// std::thread::hardware_concurrency() threads (the calling thread
+    /// processes the first block); each block contains at least
+    /// \a minimum_block items so small ranges are processed inline.
+    ///
+    /// Any exception thrown by \a f is re-thrown on the calling thread
+    /// once all blocks have completed.
+    template < typename F >
+    void parallel_for_blocks( size_t count, F f, size_t minimum_block = 1 )
+    {
+        if ( count == 0 )
+            return;
+
+        // hardware_concurrency() may read the filesystem so is queried once
+        static const size_t max_blocks = std::max( 1u, std::thread::hardware_concurrency() );
+        const size_t block_count = std::clamp<size_t>( count / std::max<size_t>( minimum_block, 1 ), 1, max_blocks );
+        if ( block_count == 1 )
+        {
+            f( size_t{0}, count );
+            return;
+        }
+
+        const size_t block_size = count / block_count;
+        const size_t remainder = count % block_count;
+        auto block_begin = [block_size, remainder]( size_t b ) {
+            return b * block_size + std::min( b, remainder );
+        };
+
+        std::vector<std::exception_ptr> errors( block_count );
+        std::vector<std::thread> threads;
+        threads.reserve( block_count - 1 );
+        for ( size_t b=1; b<block_count; ++b )
+        {
+            threads.emplace_back(
+                [&f, &errors, b, begin = block_begin(b), end = block_begin(b + 1)]() {
+                    try {
+                        f( begin, end );
+                    }
+                    catch (...) {
+                        errors[b] = std::current_exception();
+                    }
+                } );
+        }
+
+        try {
+            f( block_begin(0), block_begin(1) );
+        }
+        catch (...) {
+            errors[0] = std::current_exception();
+        }
+
+        for ( auto& t : threads )
+            t.join();
+
+        for ( const auto& e : errors )
+            if ( e )
+                std::rethrow_exception( e );
+    }
+
+}
@@ -11,10 +11,76 @@
 #include <string_view>
 #include <type_traits>
 
+// local
+#include "core/detail/half_float.h"
+
 namespace openpiv::core {
 
 #pragma pack(push, 1)
 
+/// IEEE 754 half precision (binary16) value; a storage type only,
+/// values convert to float for arithmetic. Its 11 significant bits
+/// hold e.g. normalized 16-bit camera data with half the memory and
+/// bandwidth of float
+struct half
+{
+    half() = default;
+    half( float v ) : bits( detail::float_to_half_bits( v ) ) {}
+
+    inline operator float() const { return detail::half_bits_to_float( bits ); }
+
+    static constexpr half from_bits( uint16_t b )
+    {
+        half result;
+        result.bits = b;
+        return result;
+    }
+
+    uint16_t bits{};
+};
+
+/// bfloat16 value i.e. the top 16 bits of a float: the range of float
+/// with 8 significant bits; a storage type only, as for half
+struct bfloat16
+{
+    bfloat16() = default;
+    bfloat16( float v ) : bits( detail::float_to_bfloat16_bits( v ) ) {}
+
+    inline operator float() const { return detail::bfloat16_bits_to_float( bits ); }
+
+    static constexpr bfloat16 from_bits( uint16_t b )
+    {
+        bfloat16 result;
+        result.bits = b;
+        return result;
+    }
+
+    uint16_t bits{};
+};
+
+/// type in which values of \a T are computed: \a T itself except
+/// for the 16-bit floating point storage types, which use float
+template < typename T >
+struct arithmetic_type
+{
+    using type = T;
+};
+
+template <>
+struct arithmetic_type< half >
+{
+    using type = float;
+};
+
+template <>
+struct arithmetic_type< bfloat16 >
+{
+    using type = float;
+};
+
+template < typename T >
+using arithmetic_t = typename arithmetic_type<T>::type;
+
 // rgba packed
 template < typename T >
 struct rgba
@@ -262,13 +328,19 @@ struct g
                typename = typename std::enable_if< std::is_convertible< U, T >::value >::type >
     g( U v_ ) : v(v_) {}
 
+    /// from greyscale of another type, converting via its arithmetic
+    /// type (\sa arithmetic_t)
+    template < typename U,
+               typename = typename std::enable_if< std::is_convertible< arithmetic_t<U>, T >::value >::type >
+    g( const g<U>& g_ ) : v( static_cast< arithmetic_t<U> >( g_.v ) ) {}
+
     g& operator=(const g&) = default;
     g& operator=(g&&) = default;
     template < typename U,
                typename = typename std::enable_if< std::is_convertible< U, T >::value >::type >
     inline g& operator=(U v_) { v = v_; return *this; }
 
-    inline operator T() const { return v; }
+    inline operator arithmetic_t<T>() const { return v; }
 
     T v{};
 };
@@ -279,6 +351,8 @@ using g_8  = g<uint8_t>;
 using g_16 = g<uint16_t>;
 using g_32 = g<uint32_t>;
 using g_f  = g<double>;
+using g_h  = g<half>;
+using g_bf = g<bfloat16>;
 
 inline g_8  operator ""_g8 ( unsigned long long v ) { return g_8( v ); }
 inline g_16 operator ""_g16( unsigned long long v ) { return g_16( v ); }
@@ -450,6 +524,10 @@ constexpr std::string_view pixeltype_name()
         return "g<uint32_t>";
     if constexpr (std::is_same_v<T, g_f>)
         return "g<double>";
+    if constexpr (std::is_same_v<T, g_h>)
+        return "g<half>";
+    if constexpr (std::is_same_v<T, g_bf>)
+        return "g<bfloat16>";
 
     if constexpr (std::is_same_v<T, c_8>)
         return "complex<uint8_t>";
@@ -482,3 +560,55 @@ constexpr std::string_view pixeltype_name()
 #pragma pack(pop)
 
 }
+
+namespace std {
+
+    template <>
+    struct numeric_limits< openpiv::core::half >
+    {
+        using half = openpiv::core::half;
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr int digits = 11;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -13;
+        static constexpr int max_exponent = 16;
+
+        static constexpr half min() noexcept { return half::from_bits( 0x0400 ); }
+        static constexpr half max() noexcept { return half::from_bits( 0x7bff ); }
+        static constexpr half lowest() noexcept { return half::from_bits( 0xfbff ); }
+        static constexpr half epsilon() noexcept { return half::from_bits( 0x1400 ); }
+        static constexpr half infinity() noexcept { return half::from_bits( 0x7c00 ); }
+        static constexpr half quiet_NaN() noexcept { return half::from_bits( 0x7e00 ); }
+    };
+
+    template <>
+    struct numeric_limits< openpiv::core::bfloat16 >
+    {
+        using bfloat16 = openpiv::core::bfloat16;
+
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = false;
+        static constexpr bool has_infinity = true;
+        static constexpr bool has_quiet_NaN = true;
+        static constexpr int digits = 8;
+        static constexpr int radix = 2;
+        static constexpr int min_exponent = -125;
+        static constexpr int max_exponent = 128;
+
+        static constexpr bfloat16 min() noexcept { return bfloat16::from_bits( 0x0080 ); }
+        static constexpr bfloat16 max() noexcept { return bfloat16::from_bits( 0x7f7f ); }
+        static constexpr bfloat16 lowest() noexcept { return bfloat16::from_bits( 0xff7f ); }
+        static constexpr bfloat16 epsilon() noexcept { return bfloat16::from_bits( 0x3c00 ); }
+        static constexpr bfloat16 infinity() noexcept { return bfloat16::from_bits( 0x7f80 ); }
+        static constexpr bfloat16 quiet_NaN() noexcept { return bfloat16::from_bits( 0x7fc0 ); }
+    };
+
+}
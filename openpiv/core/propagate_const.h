@@ -28,11 +28,11 @@ namespace openpiv::core {
         propagate_const(std::add_const<type_ptr> ptr) : _ptr( const_cast<type_ptr>(ptr) ) {}
 
         constexpr operator type_ptr() { return _ptr; }
-        constexpr operator const type_ptr() const { return _ptr; }
+        constexpr operator const type*() const { return _ptr; }
         constexpr type_ptr operator->() { return _ptr; }
-        constexpr const type_ptr operator->() const { return _ptr; }
+        constexpr const type* operator->() const { return _ptr; }
         constexpr type_ref operator*() { return *_ptr; }
-        constexpr const type_ref operator*() const { return *_ptr; }
+        constexpr const type& operator*() const { return *_ptr; }
 
         bool operator==( const propagate_const& rhs ) const { return _ptr == rhs._ptr; }
         bool operator!=( const propagate_const& rhs ) const { return !operator==(rhs); }
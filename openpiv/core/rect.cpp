@@ -81,6 +81,14 @@ bool rect::contains( const rect& r1 ) const
     return r1.within( *this );
 }
 
+/// does \a r1 share a non-zero area with this rectangle
+bool rect::intersects( const rect& r1 ) const
+{
+    return
+        left() < r1.right() && r1.left() < right() &&
+        bottom() < r1.top() && r1.bottom() < top();
+}
+
 /// construct a dilated rectangle; positive values of d will grow
 /// the rectangle, negative will shrink:
 ///
@@ -52,6 +52,9 @@ public:
     /// is \a r1 wholly contained within this rectangle
     bool contains( const rect& r1 ) const;
 
+    /// does \a r1 share a non-zero area with this rectangle
+    bool intersects( const rect& r1 ) const;
+
     /// construct a dilated rectangle; positive values of d will grow
     /// the rectangle, negative will shrink:
     ///
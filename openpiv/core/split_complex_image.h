@@ -0,0 +1,214 @@
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+// local
+#include "core/detail/split_complex.h"
+#include "core/exception_builder.h"
+#include "core/image.h"
+#include "core/pixel_types.h"
+#include "core/size.h"
+
+namespace openpiv::core {
+
+    /// complex image stored as separate planes of real and imaginary
+    /// parts ("split complex") rather than as interleaved complex<T>.
+    /// Products, magnitudes and normalization of spectra then work on
+    /// whole vectors of real and imaginary parts without the shuffles
+    /// needed for interleaved data; \sa conj_multiply, abs_sqr, abs,
+    /// normalize.
+    ///
+    /// Each plane is a packed image< g<T> >, so may be used directly
+    /// wherever a greyscale image is expected.
+    template < typename T >
+    class split_complex_image
+    {
+        static_assert( std::is_floating_point_v<T>, "split_complex_image requires floating point values" );
+
+    public:
+        using value_t = T;
+        using pixel_t = complex<T>;
+        using plane_t = image< g<T> >;
+
+        split_complex_image() = default;
+
+        /// zero image of size \a s
+        explicit split_complex_image( const core::size& s )
+            : real_( s )
+            , imag_( s )
+        {}
+        split_complex_image( uint32_t w, uint32_t h )
+            : split_complex_image( core::size{ w, h } )
+        {}
+
+        /// split copy of interleaved \a im
+        template < typename U >
+        explicit split_complex_image( const image< complex<U> >& im )
+        {
+            *this = im;
+        }
+
+        /// split copy of interleaved \a im
+        template < typename U >
+        split_complex_image& operator=( const image< complex<U> >& im )
+        {
+            resize( im.size() );
+            for ( uint32_t h = 0; h < height(); ++h )
+            {
+                if constexpr ( std::is_same_v<T, U> )
+                    detail::deinterleave_row( im.line( h ), real_line( h ), imag_line( h ), width() );
+                else
+                {
+                    const complex<U>* in = im.line( h );
+                    for ( uint32_t w = 0; w < width(); ++w )
+                    {
+                        real_line( h )[w] = static_cast<T>( in[w].real );
+                        imag_line( h )[w] = static_cast<T>( in[w].imag );
+                    }
+                }
+            }
+
+            return *this;
+        }
+
+        /// interleave into \a out, resizing it to size()
+        void interleave( image< complex<T> >& out ) const
+        {
+            out.resize( size() );
+            for ( uint32_t h = 0; h < height(); ++h )
+                detail::interleave_row( real_line( h ), imag_line( h ), out.line( h ), width() );
+        }
+
+        /// \returns an interleaved copy
+        image< complex<T> > interleaved() const
+        {
+            image< complex<T> > result;
+            interleave( result );
+            return result;
+        }
+
+        /// resize the image; this is destructive
+        void resize( const core::size& s )
+        {
+            real_.resize( s );
+            imag_.resize( s );
+        }
+
+        inline bool operator==( const split_complex_image& rhs ) const { return real_ == rhs.real_ && imag_ == rhs.imag_; }
+        inline bool operator!=( const split_complex_image& rhs ) const { return !operator==( rhs ); }
+
+        /// \returns the pixel at \a xy
+        inline complex<T> operator[]( const point2<uint32_t>& xy ) const
+        {
+            return { real_[xy].v, imag_[xy].v };
+        }
+
+        /// set the pixel at \a xy to \a v
+        inline void set( const point2<uint32_t>& xy, const complex<T>& v )
+        {
+            real_[xy] = v.real;
+            imag_[xy] = v.imag;
+        }
+
+        /// planes
+        inline plane_t& real() { return real_; }
+        inline const plane_t& real() const { return real_; }
+        inline plane_t& imag() { return imag_; }
+        inline const plane_t& imag() const { return imag_; }
+
+        /// raw rows of the planes
+        inline T* real_line( size_t h ) { return &real_.line( h )->v; }
+        inline const T* real_line( size_t h ) const { return &real_.line( h )->v; }
+        inline T* imag_line( size_t h ) { return &imag_.line( h )->v; }
+        inline const T* imag_line( size_t h ) const { return &imag_.line( h )->v; }
+
+        /// geometry accessors
+        inline uint32_t width() const { return real_.width(); }
+        inline uint32_t height() const { return real_.height(); }
+        inline core::size size() const { return real_.size(); }
+        inline size_t pixel_count() const { return real_.pixel_count(); }
+
+    private:
+        plane_t real_;
+        plane_t imag_;
+    };
+
+    using split_cf_image = split_complex_image< double >;
+
+    /// \a out = \a b * conj( \a a ), split or interleaved; this is the
+    /// product of spectra in a cross correlation
+    template < typename T, typename OutT >
+    void conj_multiply( const split_complex_image<T>& a,
+                        const split_complex_image<T>& b,
+                        OutT& out )
+    {
+        if ( a.size() != b.size() )
+            exception_builder<std::runtime_error>()
+                << "image sizes are different: " << a.size() << ", " << b.size();
+
+        out.resize( a.size() );
+        for ( uint32_t h = 0; h < a.height(); ++h )
+        {
+            if constexpr ( std::is_same_v< OutT, split_complex_image<T> > )
+                detail::conj_multiply_row( a.real_line( h ), a.imag_line( h ),
+                                           b.real_line( h ), b.imag_line( h ),
+                                           out.real_line( h ), out.imag_line( h ), a.width() );
+            else
+            {
+                static_assert( std::is_same_v< OutT, image< complex<T> > >,
+                               "output must be a split or interleaved complex image" );
+                detail::conj_multiply_row( a.real_line( h ), a.imag_line( h ),
+                                           b.real_line( h ), b.imag_line( h ),
+                                           out.line( h ), a.width() );
+            }
+        }
+    }
+
+    /// \returns the squared magnitudes of \a im
+    template < typename T >
+    image< g<T> > abs_sqr( const split_complex_image<T>& im )
+    {
+        image< g<T> > result{ im.size() };
+        for ( uint32_t h = 0; h < im.height(); ++h )
+            detail::abs_sqr_row( im.real_line( h ), im.imag_line( h ), &result.line( h )->v, im.width() );
+
+        return result;
+    }
+
+    /// \returns the magnitudes of \a im
+    template < typename T >
+    image< g<T> > abs( const split_complex_image<T>& im )
+    {
+        image< g<T> > result{ im.size() };
+        for ( uint32_t h = 0; h < im.height(); ++h )
+            detail::abs_row( im.real_line( h ), im.imag_line( h ), &result.line( h )->v, im.width() );
+
+        return result;
+    }
+
+    /// scale each pixel of \a im to unit magnitude, e.g. to whiten a
+    /// cross spectrum for phase correlation; pixels with magnitude not
+    /// greater than \a epsilon are set to zero
+    template < typename T >
+    split_complex_image<T>& normalize( split_complex_image<T>& im, T epsilon = T{} )
+    {
+        for ( uint32_t h = 0; h < im.height(); ++h )
+            detail::normalize_row( im.real_line( h ), im.imag_line( h ), im.width(), epsilon );
+
+        return im;
+    }
+
+    /// ostream operator
+    template < typename T >
+    std::ostream& operator<<( std::ostream& os, const split_complex_image<T>& p )
+    {
+        os << "split_complex_image<" << pixeltype_name< complex<T> >() << ">[" << p.size() << "]";
+
+        return os;
+    }
+
+}
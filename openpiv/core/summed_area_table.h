@@ -0,0 +1,192 @@
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// local
+#include "core/detail/prefix_scan.h"
+#include "core/exception_builder.h"
+#include "core/image_type_traits.h"
+#include "core/parallel.h"
+#include "core/pixel_types.h"
+#include "core/rect.h"
+#include "core/size.h"
+
+namespace openpiv::core {
+
+    /// accumulator used for a summed-area table of pixels of type
+    /// \ta T: 64-bit integers for integral pixels, double otherwise
+    template < typename T, typename = void >
+    struct sat_accumulator { using type = double; };
+
+    template < typename T >
+    struct sat_accumulator< g<T>, std::enable_if_t<std::is_integral_v<T>> > { using type = int64_t; };
+
+    template < typename T >
+    using sat_accumulator_t = typename sat_accumulator<T>::type;
+
+    /// accumulator used for a squared summed-area table of pixels of
+    /// type \ta T; squares of 32-bit pixels may overflow a 64-bit
+    /// integer so fall back to double
+    template < typename T, typename = void >
+    struct sat_squared_accumulator { using type = double; };
+
+    template < typename T >
+    struct sat_squared_accumulator< g<T>, std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= 2> > { using type = int64_t; };
+
+    template < typename T >
+    using sat_squared_accumulator_t = typename sat_squared_accumulator<T>::type;
+
+
+    /// summed-area table (integral image) of an image: allows the sum
+    /// of any rectangular window to be found in O(1).
+    ///
+    /// The table has one more row and column than the source image
+    /// such that at( x, y ) is the sum of all pixels in
+    /// rect{ {0, 0}, {x, y} }.
+    ///
+    /// Rows are converted and prefix-scanned in parallel blocks, then
+    /// the vertical accumulation is performed in parallel column
+    /// strips.
+    template < typename AccT >
+    class summed_area_table
+    {
+    public:
+        using value_t = AccT;
+
+        summed_area_table() = default;
+
+        /// build a table of the pixel values of \a im
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+                   >
+        explicit summed_area_table( const ImageT<ContainedT>& im )
+            : summed_area_table( im, []( const ContainedT& v ){ return static_cast<AccT>( v ); } )
+        {}
+
+        /// build a table of \a op applied to each pixel of \a im; \a op
+        /// is of the form:
+        ///
+        /// AccT op( const ContainedT& )
+        template < template <typename> class ImageT,
+                   typename ContainedT,
+                   typename OpT,
+                   typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >,
+                   typename = typename std::enable_if_t< std::is_invocable_v<OpT, const ContainedT&> >
+                   >
+        summed_area_table( const ImageT<ContainedT>& im, OpT op )
+            : size_( im.size() )
+            , stride_( im.width() + 1 )
+            , table_( stride_ * (im.height() + 1) )
+        {
+            const uint32_t width = im.width();
+            const uint32_t height = im.height();
+            if ( width == 0 || height == 0 )
+                return;
+
+            // keep each block to a reasonable amount of work
+            constexpr size_t block_pixels = 1 << 16;
+
+            parallel_for_blocks(
+                height,
+                [this, &im, &op, width]( size_t begin, size_t end ) {
+                    for ( size_t h=begin; h<end; ++h )
+                    {
+                        const ContainedT* line = im.line( h );
+                        AccT* row = &table_[ (h + 1) * stride_ + 1 ];
+                        for ( uint32_t w=0; w<width; ++w )
+                            row[w] = op( line[w] );
+                        detail::inclusive_scan( row, width );
+                    }
+                },
+                std::max<size_t>( 1, block_pixels / width ) );
+
+            parallel_for_blocks(
+                stride_,
+                [this, height]( size_t begin, size_t end ) {
+                    for ( size_t h=2; h<=height; ++h )
+                    {
+                        const AccT* previous = &table_[ (h - 1) * stride_ ];
+                        AccT* row = &table_[ h * stride_ ];
+                        for ( size_t w=begin; w<end; ++w )
+                            row[w] += previous[w];
+                    }
+                },
+                std::max<size_t>( 64, block_pixels / height ) );
+        }
+
+        /// size of the source image
+        inline const core::size& size() const { return size_; }
+
+        /// \returns the sum of all pixels in rect{ {0, 0}, {x, y} }
+        inline AccT at( uint32_t x, uint32_t y ) const { return table_[ y * stride_ + x ]; }
+
+        /// \returns the sum of pixels within \a r; \a r must lie
+        /// within the source image
+        AccT sum( const core::rect& r ) const
+        {
+            if ( !rect::from_size( size_ ).contains( r ) )
+                exception_builder<std::out_of_range>()
+                    << "window (" << r << ") not contained within image (" << size_ << ")";
+
+            const uint32_t l = r.left(), b = r.bottom(), rt = r.right(), t = r.top();
+            return at( rt, t ) - at( l, t ) - at( rt, b ) + at( l, b );
+        }
+
+        /// \returns the mean of pixels within \a r
+        double mean( const core::rect& r ) const
+        {
+            const auto n = r.area();
+            return n == 0 ? 0.0 : static_cast<double>( sum( r ) ) / n;
+        }
+
+    private:
+        core::size size_;
+        size_t stride_ = 0;
+        std::vector<AccT> table_;
+    };
+
+    /// \returns a summed-area table of \a im
+    template < template <typename> class ImageT,
+               typename ContainedT,
+               typename ReturnT = summed_area_table< sat_accumulator_t<ContainedT> >,
+               typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+               >
+    ReturnT make_summed_area_table( const ImageT<ContainedT>& im )
+    {
+        return ReturnT{ im };
+    }
+
+    /// \returns a summed-area table of the squares of the pixels of \a im
+    template < template <typename> class ImageT,
+               typename ContainedT,
+               typename ReturnT = summed_area_table< sat_squared_accumulator_t<ContainedT> >,
+               typename = typename std::enable_if_t< is_imagetype_v<ImageT<ContainedT>> >
+               >
+    ReturnT make_squared_summed_area_table( const ImageT<ContainedT>& im )
+    {
+        using acc_t = typename ReturnT::value_t;
+        return ReturnT{ im, []( const ContainedT& v ){ const auto a = static_cast<acc_t>( v ); return a*a; } };
+    }
+
+    /// \returns the (population) variance of pixels within \a r given
+    /// tables of the pixels and their squares
+    template < typename SumT, typename SquaredSumT >
+    double variance( const summed_area_table<SumT>& sum,
+                     const summed_area_table<SquaredSumT>& sum_sqr,
+                     const core::rect& r )
+    {
+        const auto n = r.area();
+        if ( n == 0 )
+            return 0.0;
+
+        const double mean = sum.mean( r );
+        return std::max( 0.0, sum_sqr.mean( r ) - mean*mean );
+    }
+
+}
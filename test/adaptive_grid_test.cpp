@@ -0,0 +1,112 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+
+// std
+#include <algorithm>
+
+// to be tested
+#include "core/adaptive_grid.h"
+
+using namespace openpiv::core;
+
+namespace {
+    struct result_t
+    {
+        vector2<double> v;
+        double sn = 0.0;
+    };
+
+    auto displacement = []( const result_t& r ){ return r.v; };
+    auto peak_ratio = []( const result_t& r ){ return r.sn; };
+}
+
+TEST_CASE("adaptive_grid_test - initial grid matches cartesian grid")
+{
+    adaptive_grid<result_t> grid{ {100, 50}, {32, 32}, 0.5, {8, 8} };
+    auto expected = generate_cartesian_grid( {100, 50}, {32, 32}, 0.5 );
+
+    REQUIRE( grid.root_count() == expected.size() );
+    REQUIRE( grid.rects( grid.leaves() ) == expected );
+}
+
+TEST_CASE("adaptive_grid_test - subdivide")
+{
+    adaptive_grid<result_t> grid{ {64, 64}, {32, 32}, 1.0, {8, 8} };
+    REQUIRE( grid.root_count() == 4 );
+
+    auto children = grid.subdivide( 0 );
+    REQUIRE( grid.size() == 8 );
+    REQUIRE_FALSE( grid[0].is_leaf() );
+    REQUIRE( grid[children[0]].r == rect{ {0, 0}, {16, 16} } );
+    REQUIRE( grid[children[1]].r == rect{ {16, 0}, {16, 16} } );
+    REQUIRE( grid[children[2]].r == rect{ {0, 16}, {16, 16} } );
+    REQUIRE( grid[children[3]].r == rect{ {16, 16}, {16, 16} } );
+    for ( const auto& c : children )
+    {
+        REQUIRE( grid[c].parent == 0 );
+        REQUIRE( grid[c].level == 1 );
+    }
+
+    // leaves are now 3 roots + 4 children
+    REQUIRE( grid.leaves().size() == 7 );
+
+    // can't subdivide a non-leaf or below the minimum size
+    REQUIRE_FALSE( grid.can_subdivide( 0 ) );
+    auto grandchildren = grid.subdivide( children[0] );
+    REQUIRE( grid[grandchildren[0]].r.size() == size{ 8, 8 } );
+    REQUIRE_FALSE( grid.can_subdivide( grandchildren[0] ) );
+    REQUIRE_THROWS( grid.subdivide( grandchildren[0] ) );
+}
+
+TEST_CASE("adaptive_grid_test - neighbours")
+{
+    adaptive_grid<result_t> grid{ {96, 96}, {32, 32}, 1.0, {8, 8} };
+    REQUIRE( grid.root_count() == 9 );
+
+    // centre root touches all others
+    REQUIRE( grid.neighbours( 4 ).size() == 8 );
+
+    // corner root touches three others
+    REQUIRE( grid.neighbours( 0 ) == std::vector<size_t>{ 1, 3, 4 } );
+
+    // subdivided neighbours are reported as their touching leaves
+    auto children = grid.subdivide( 1 );
+    auto n = grid.neighbours( 0 );
+    REQUIRE( std::find( std::begin(n), std::end(n), 1 ) == std::end(n) );
+    REQUIRE( std::find( std::begin(n), std::end(n), children[0] ) != std::end(n) );
+    REQUIRE( std::find( std::begin(n), std::end(n), children[2] ) != std::end(n) );
+    REQUIRE( std::find( std::begin(n), std::end(n), children[1] ) == std::end(n) );
+}
+
+TEST_CASE("adaptive_grid_test - refine by peak ratio")
+{
+    adaptive_grid<result_t> grid{ {64, 64}, {32, 32}, 1.0, {8, 8} };
+    for ( size_t i=0; i<grid.size(); ++i )
+        grid[i].value = result_t{ {}, i == 2 ? 1.0 : 3.0 };
+
+    auto added = refine_by_quality( grid, refinement_criteria{ 1.5, 1.0 }, displacement, peak_ratio );
+    REQUIRE( added.size() == 4 );
+    REQUIRE( grid[added[0]].parent == 2 );
+
+    // new leaves have no values so are not refined further
+    added = refine_by_quality( grid, refinement_criteria{ 1.5, 1.0 }, displacement, peak_ratio );
+    REQUIRE( added.empty() );
+}
+
+TEST_CASE("adaptive_grid_test - refine by gradient")
+{
+    adaptive_grid<result_t> grid{ {128, 32}, {32, 32}, 1.0, {8, 8} };
+    REQUIRE( grid.root_count() == 4 );
+
+    // shear layer between roots 1 and 2
+    for ( size_t i=0; i<grid.size(); ++i )
+        grid[i].value = result_t{ { i < 2 ? 0.0 : 8.0, 0.0 }, 3.0 };
+
+    auto added = refine_by_quality( grid, refinement_criteria{ 1.5, 0.1 }, displacement, peak_ratio );
+    REQUIRE( added.size() == 8 );
+    REQUIRE_FALSE( grid[1].is_leaf() );
+    REQUIRE_FALSE( grid[2].is_leaf() );
+    REQUIRE( grid[0].is_leaf() );
+    REQUIRE( grid[3].is_leaf() );
+}
@@ -0,0 +1,83 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/block_matching.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    template < typename T >
+    image<g<T>> make_window( const size& s, uint32_t dx, uint32_t dy )
+    {
+        image<g<T>> result{ s };
+        fill( result, [dx, dy]( uint32_t x, uint32_t y ){ return ((x + dx) * 7 + (y + dy) * 13) % 17 * 15; } );
+        return result;
+    }
+}
+
+TEST_CASE("block_matching_test - finds displacement")
+{
+    const size s{ 48, 32 };
+    const auto a = make_window<double>( s, 0, 0 );
+    const auto b = make_window<double>( s, 0, 0 );
+
+    for ( auto metric : { match_metric::SAD, match_metric::MQD } )
+    {
+        BlockMatching matcher{ s, 4, metric };
+        gf_image output{ matcher.cross_correlate( a, b ) };
+        REQUIRE( output.size() == s );
+
+        // identical windows match exactly at zero displacement
+        const double centre = output[ {24, 16} ];
+        REQUIRE_THAT( centre, WithinAbs( 1.0, 1e-12 ) );
+
+        // lags outside the search radius are not evaluated
+        const double outside = output[ {24 + 5, 16} ];
+        REQUIRE( outside == 0.0 );
+    }
+}
+
+TEST_CASE("block_matching_test - peak follows shift")
+{
+    const size s{ 32, 32 };
+    const auto a = make_window<uint8_t>( s, 0, 0 );
+    const auto b = make_window<uint8_t>( s, 0, 0 );
+
+    // b is a shifted by (3, -2)
+    g8_image shifted{ s };
+    fill( shifted, [&a]( uint32_t x, uint32_t y ){ return a[ { (x + 29) % 32, (y + 2) % 32 } ]; } );
+
+    BlockMatching matcher{ s, 4 };
+    gf_image output{ matcher.cross_correlate( a, shifted ) };
+    auto peaks = find_peaks( output, 1, 1 );
+    REQUIRE( peaks.size() == 1 );
+    REQUIRE( peaks[0].rect().midpoint() == rect::point_t{ 16 + 3, 16 - 2 } );
+}
+
+TEST_CASE("block_matching_test - 8-bit matches generic path")
+{
+    // odd width exercises the scalar remainder
+    const size s{ 45, 20 };
+    const auto a = make_window<uint8_t>( s, 0, 0 );
+    const auto b = make_window<uint8_t>( s, 2, 1 );
+
+    for ( auto metric : { match_metric::SAD, match_metric::MQD } )
+    {
+        BlockMatching matcher{ s, 6, metric };
+        gf_image output{ matcher.cross_correlate( a, b ) };
+        gf_image expected{ matcher.cross_correlate( gf_image{ a }, gf_image{ b } ) };
+
+        for ( uint32_t i=0; i<output.pixel_count(); ++i )
+            REQUIRE_THAT( (double)output[i], WithinAbs( expected[i], 1e-12 ) );
+    }
+}
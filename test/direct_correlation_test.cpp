@@ -0,0 +1,107 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cstdlib>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/direct_correlation.h"
+#include "algos/fft.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    gf_image make_window( const size& s, uint32_t offset )
+    {
+        gf_image result{ s };
+        fill( result, [offset]( uint32_t x, uint32_t y ){ return ((x + offset) * 7 + y * 13) % 17; } );
+        return result;
+    }
+}
+
+TEST_CASE("direct_correlation_test - matches FFT within lag range")
+{
+    const size s{ 32, 32 };
+    const auto a = make_window( s, 0 );
+    const auto b = make_window( s, 3 );
+
+    DirectCorrelation direct{ s, 4 };
+    REQUIRE_FALSE( direct.uses_fft() );
+    FFT fft{ s };
+
+    gf_image expected{ fft.cross_correlate( a, b ) };
+    gf_image output{ direct.cross_correlate( a, b ) };
+    REQUIRE( output.size() == s );
+
+    for ( uint32_t y=0; y<s.height(); ++y )
+        for ( uint32_t x=0; x<s.width(); ++x )
+        {
+            const bool in_range = std::abs( (int)x - 16 ) <= 4 && std::abs( (int)y - 16 ) <= 4;
+            const double v = output[ {x, y} ];
+            const double e = in_range ? (double)expected[ {x, y} ] : 0.0;
+            REQUIRE_THAT( v, WithinAbs( e, 1e-6 ) );
+        }
+}
+
+TEST_CASE("direct_correlation_test - non power of two size")
+{
+    const size s{ 24, 20 };
+    const auto a = make_window( s, 0 );
+    DirectCorrelation direct{ s, 100 };
+    REQUIRE_FALSE( direct.uses_fft() );
+
+    // auto-correlation peaks at zero displacement
+    gf_image output{ direct.cross_correlate( a, a ) };
+    auto peaks = find_peaks( output, 1, 1 );
+    REQUIRE( peaks.size() == 1 );
+    REQUIRE( peaks[0].rect().midpoint() == rect::point_t{ 12, 10 } );
+}
+
+TEST_CASE("direct_correlation_test - crossover to FFT")
+{
+    REQUIRE( DirectCorrelation::prefer_direct( {32, 32}, 4 ) );
+    REQUIRE( DirectCorrelation::prefer_direct( {32, 32}, 6 ) );
+    REQUIRE_FALSE( DirectCorrelation::prefer_direct( {32, 32}, 16 ) );
+
+    const size s{ 32, 32 };
+    DirectCorrelation direct{ s, 16 };
+    REQUIRE( direct.uses_fft() );
+
+    const auto a = make_window( s, 0 );
+    const auto b = make_window( s, 5 );
+    FFT fft{ s };
+    gf_image expected{ fft.cross_correlate( a, b ) };
+    gf_image output{ direct.cross_correlate( a, b ) };
+    const double e = expected[ {10, 20} ];
+    const double v = output[ {10, 20} ];
+    REQUIRE_THAT( v, WithinAbs( e, 1e-6 ) );
+}
+
+TEST_CASE("direct_correlation_test - zncc")
+{
+    const size s{ 16, 16 };
+    const auto a = make_window( s, 0 );
+    DirectCorrelation direct{ s, 2 };
+
+    double sum = 0, sum_sqr = 0;
+    for ( uint32_t i=0; i<a.pixel_count(); ++i )
+    {
+        sum += a[i];
+        sum_sqr += a[i] * a[i];
+    }
+    const double mean = sum / s.area();
+    const double stddev = std::sqrt( sum_sqr / s.area() - mean * mean );
+
+    gf_image output{ direct.cross_correlate_zncc( a, a, zncc_normalization{ s, mean, stddev, mean, stddev } ) };
+    const double centre = output[ {8, 8} ];
+    REQUIRE_THAT( centre, WithinAbs( 1.0, 1e-9 ) );
+}
@@ -0,0 +1,101 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <random>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/ensemble_correlation.h"
+#include "algos/fft.h"
+#include "core/grid.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    /// a frame of single pixel particles, and the same particles
+    /// moved by (\a dx, \a dy)
+    std::tuple<gf_image, gf_image> make_pair( const size& s, uint32_t particles, int32_t dx, int32_t dy, uint32_t seed )
+    {
+        std::mt19937 gen( seed );
+        std::uniform_int_distribution<uint32_t> x_dist( 0, s.width() - 1 );
+        std::uniform_int_distribution<uint32_t> y_dist( 0, s.height() - 1 );
+
+        gf_image a{ s };
+        gf_image b{ s };
+        for ( uint32_t i=0; i<particles; ++i )
+        {
+            const uint32_t x = x_dist( gen );
+            const uint32_t y = y_dist( gen );
+            a[ {x, y} ] = 255;
+            b[ { (x + dx + s.width()) % s.width(), (y + dy + s.height()) % s.height() } ] = 255;
+        }
+
+        return { a, b };
+    }
+}
+
+TEST_CASE("ensemble_correlation_test - single pair matches cross_correlate")
+{
+    const size s{ 64, 64 };
+    const auto [a, b] = make_pair( s, 40, 3, 1, 1 );
+    const auto grid = generate_cartesian_grid( s, { 32, 32 }, 0.5 );
+
+    EnsembleCorrelation<> ensemble{ grid };
+    ensemble.add( a, b );
+    REQUIRE( ensemble.pair_count() == 1 );
+
+    FFT fft{ { 32, 32 } };
+    for ( size_t i=0; i<grid.size(); ++i )
+    {
+        const gf_image expected{ fft.cross_correlate( create_image_view( a, grid[i] ), create_image_view( b, grid[i] ) ) };
+        const gf_image output{ ensemble.correlation( i ) };
+        for ( uint32_t j=0; j<output.pixel_count(); ++j )
+            REQUIRE_THAT( (double)output[j], WithinAbs( expected[j], 1e-6 ) );
+    }
+}
+
+TEST_CASE("ensemble_correlation_test - averages over pairs")
+{
+    const size s{ 32, 32 };
+    const std::vector<rect> grid{ rect{ {0, 0}, s } };
+    EnsembleCorrelation<> ensemble{ grid };
+    FFT fft{ s };
+
+    gf_image expected{ s };
+    constexpr uint32_t pairs = 8;
+    for ( uint32_t i=0; i<pairs; ++i )
+    {
+        const auto [a, b] = make_pair( s, 2, -2, 1, i );
+        ensemble.add( a, b );
+        expected = expected + gf_image{ fft.cross_correlate( a, b ) } * g_f{ 1.0 / pairs };
+    }
+
+    const gf_image output{ ensemble.correlation( 0 ) };
+    for ( uint32_t j=0; j<output.pixel_count(); ++j )
+        REQUIRE_THAT( (double)output[j], WithinAbs( expected[j], 1e-6 ) );
+
+    // too few particles in each pair for a reliable peak but the
+    // ensemble recovers the displacement
+    auto peaks = find_peaks( output, 1, 1 );
+    REQUIRE( peaks.size() == 1 );
+    REQUIRE( peaks[0].rect().midpoint() == rect::point_t{ 16 - 2, 16 + 1 } );
+
+    ensemble.reset();
+    REQUIRE( ensemble.pair_count() == 0 );
+    REQUIRE_THROWS( ensemble.correlation( 0 ) );
+}
+
+TEST_CASE("ensemble_correlation_test - invalid grid")
+{
+    REQUIRE_THROWS( EnsembleCorrelation<>{ std::vector<rect>{} } );
+    REQUIRE_THROWS( EnsembleCorrelation<>{ { rect{ {0, 0}, {32, 32} }, rect{ {0, 0}, {16, 16} } } } );
+}
@@ -0,0 +1,93 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <numeric>
+#include <type_traits>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "core/fixed_image.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "algos/stats.h"
+
+using namespace Catch;
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+TEST_CASE("fixed_image_test - basic_construction_test")
+{
+    using fixed_t = fixed_image< g_f, 5, 3 >;
+    STATIC_REQUIRE( is_imagetype_v< fixed_t > );
+    STATIC_REQUIRE( std::is_trivially_copyable_v< fixed_t > );
+    STATIC_REQUIRE( sizeof( fixed_t ) == 5*3*sizeof( g_f ) + sizeof( rect::point_t ) );
+
+    fixed_t im;
+    CHECK( im.width() == 5 );
+    CHECK( im.height() == 3 );
+    CHECK( im.size() == size{ 5, 3 } );
+    CHECK( im.pixel_count() == 15 );
+    CHECK( im.rect() == rect::from_size( { 5, 3 } ) );
+    CHECK( im.is_packed() );
+    CHECK( std::all_of( std::begin( im ), std::end( im ), []( g_f v ){ return v == 0; } ) );
+
+    fixed_t filled{ 3 };
+    CHECK( std::all_of( std::begin( filled ), std::end( filled ), []( g_f v ){ return v == 3; } ) );
+    CHECK( filled != im );
+}
+
+TEST_CASE("fixed_image_test - pixel_access_test")
+{
+    fixed_image< g_16, 4, 3 > im;
+    std::iota( std::begin( im ), std::end( im ), 0 );
+
+    CHECK( im[ 5 ] == 5 );
+    CHECK( im[ {1, 2} ] == 9 );
+    CHECK( im.line( 2 )[ 3 ] == 11 );
+
+    uint32_t rows = 0;
+    for ( auto row : im.rows() )
+    {
+        CHECK( row.size() == 4 );
+        CHECK( row[0] == 4 * rows++ );
+    }
+    CHECK( rows == 3 );
+}
+
+TEST_CASE("fixed_image_test - copy_from_test")
+{
+    gf_image im{ rect{ {10, 20}, {20, 20} } };
+    std::iota( std::begin( im ), std::end( im ), 0 );
+
+    auto peak = fixed_image< g_f, 3, 3 >::copy_from( im, {4, 5} );
+    CHECK( peak.rect() == rect( {14, 25}, {3, 3} ) );
+    for ( uint32_t h=0; h<3; ++h )
+        for ( uint32_t w=0; w<3; ++w )
+            CHECK( peak[ {w, h} ] == im[ {4 + w, 5 + h} ] );
+
+    // views keep their global position
+    const auto view = create_image_view( im, rect{ {2, 3}, {10, 10} } );
+    auto from_view = fixed_image< g_f, 3, 3 >::copy_from( view, {2, 2} );
+    CHECK( from_view.rect() == rect( {14, 25}, {3, 3} ) );
+    CHECK( from_view == peak );
+
+    REQUIRE_THROWS( fixed_image< g_f, 3, 3 >::copy_from( im, {18, 0} ) );
+    REQUIRE_THROWS( fixed_image< g_f, 3, 3 >::copy_from( view, {0, 8} ) );
+}
+
+TEST_CASE("fixed_image_test - reduce_test")
+{
+    fixed_image< g_f, 5, 5 > im;
+    std::iota( std::begin( im ), std::end( im ), 1 );
+
+    auto [ lo, hi, total ] = reduce< min_reduction, max_reduction, sum_reduction >( im );
+    CHECK( lo == 1 );
+    CHECK( hi == 25 );
+    CHECK( total == 25*26/2 );
+}
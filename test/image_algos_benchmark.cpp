@@ -3,7 +3,12 @@
 #include <benchmark/benchmark.h>
 
 // openpiv
+#include "algos/block_matching.h"
+#include "algos/direct_correlation.h"
 #include "algos/fft.h"
+#include "algos/integer_correlation.h"
+#include "algos/pocket_fft.h"
+#include "algos/sliding_dft.h"
 #include "loaders/image_loader.h"
 
 // test
@@ -86,4 +91,117 @@ static void fft_auto_correlation_extract_benchmark(benchmark::State& state)
 // Register the function as a benchmark
 BENCHMARK(fft_auto_correlation_extract_benchmark)->Threads(4)->RangeMultiplier(2)->Range(4, 64);
 
+static void direct_cross_correlation_benchmark(benchmark::State& state)
+{
+    gf_image im_a{ load_from_file< g_f >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ d, d };
+    DirectCorrelation direct( s, (uint32_t)state.range(1) );
+
+    auto sub_a = extract( im_a, rect{ {0, 0}, s } );
+    auto sub_b = extract( im_a, rect{ {1, 1}, s } );
+
+    for (auto _ : state)
+    {
+        // measure direct correlation speed
+        direct.cross_correlate( sub_a, sub_b );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(direct_cross_correlation_benchmark)->Threads(4)->ArgsProduct({{16, 32, 64}, {2, 4, 8}});
+
+static void integer_cross_correlation_benchmark(benchmark::State& state)
+{
+    g16_image im_a{ load_from_file< g_16 >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ d, d };
+    IntegerCorrelation integer( s, (uint32_t)state.range(1) );
+
+    auto sub_a = extract( im_a, rect{ {0, 0}, s } );
+    auto sub_b = extract( im_a, rect{ {1, 1}, s } );
+
+    for (auto _ : state)
+    {
+        // measure integer correlation speed
+        integer.cross_correlate( sub_a, sub_b );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(integer_cross_correlation_benchmark)->Threads(4)->ArgsProduct({{16, 32, 64}, {2, 4, 8}});
+
+static void pocket_fft_cross_correlation_benchmark(benchmark::State& state)
+{
+    gf_image im_a{ load_from_file< g_f >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ d, d };
+    PocketFFT fft( s );
+
+    auto sub_a = extract( im_a, rect{ {0, 0}, s } );
+    auto sub_b = extract( im_a, rect{ {1, 1}, s } );
+
+    for (auto _ : state)
+    {
+        // measure FFT speed
+        fft.cross_correlate( sub_a, sub_b );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(pocket_fft_cross_correlation_benchmark)->Threads(4)->RangeMultiplier(2)->Range(16, 64);
+
+static void sad_block_matching_benchmark(benchmark::State& state)
+{
+    g8_image im_a{ load_from_file< g_16 >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ d, d };
+    BlockMatching matcher( s, (uint32_t)state.range(1), match_metric::SAD );
+
+    auto sub_a = extract( im_a, rect{ {0, 0}, s } );
+    auto sub_b = extract( im_a, rect{ {1, 1}, s } );
+
+    for (auto _ : state)
+    {
+        // measure block matching speed
+        matcher.cross_correlate( sub_a, sub_b );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(sad_block_matching_benchmark)->Threads(4)->ArgsProduct({{16, 32, 64}, {2, 4, 8}});
+
+static void sliding_dft_row_benchmark(benchmark::State& state)
+{
+    gf_image im_a{ load_from_file< g_f >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    uint32_t step{ (uint32_t)state.range(1) };
+    size s{ d, d };
+    SlidingDFT sliding( s );
+
+    for (auto _ : state)
+    {
+        // measure transforms of a row of windows
+        sliding.start( im_a, rect{ {0, 0}, s } );
+        for ( uint32_t x = step; x + d <= im_a.width(); x += step )
+            sliding.advance( step );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(sliding_dft_row_benchmark)->ArgsProduct({{16, 32, 64}, {1, 2, 4, 8}});
+
+static void fft_row_benchmark(benchmark::State& state)
+{
+    gf_image im_a{ load_from_file< g_f >( "corr_a.tiff" ) };
+    uint32_t d{ (uint32_t)state.range(0) };
+    uint32_t step{ (uint32_t)state.range(1) };
+    size s{ d, d };
+    FFT fft( s );
+
+    for (auto _ : state)
+    {
+        // measure transforms of a row of windows
+        for ( uint32_t x = 0; x + d <= im_a.width(); x += step )
+            fft.transform( create_image_view( im_a, rect{ {(int32_t)x, 0}, s } ) );
+    }
+}
+// Register the function as a benchmark
+BENCHMARK(fft_row_benchmark)->ArgsProduct({{16, 32, 64}, {1, 2, 4, 8}});
+
 BENCHMARK_MAIN();
@@ -11,6 +11,7 @@
 
 // to be tested
 #include "algos/fft.h"
+#include "algos/window_stats.h"
 #include "loaders/image_loader.h"
 #include "core/image_utils.h"
 
@@ -150,6 +151,40 @@ TEST_CASE("image_algos_test - cross_correlation_test")
     REQUIRE( save_to_file( "cross-correlate-output.pgm", output ) );
 }
 
+TEST_CASE("image_algos_test - zncc_test")
+{
+    // b is a brighter, higher contrast copy of a
+    gf_image a{ 32, 32 };
+    fill( a, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13) % 17; } );
+    gf_image b{ a.size() };
+    b = a * g_f{ 2.0 } + g_f{ 10.0 };
+
+    const auto sa = window_statistics{ a }( rect::from_size( a.size() ) );
+    const auto sb = window_statistics{ b }( rect::from_size( b.size() ) );
+    const zncc_normalization n{ a.size(), sa.mean, sa.stddev, sb.mean, sb.stddev };
+
+    FFT fft( a.size() );
+    gf_image output{ fft.cross_correlate_zncc( a, b, n ) };
+
+    // zero displacement is perfectly correlated
+    const double centre = output[ {16, 16} ];
+    REQUIRE_THAT( centre, WithinAbs( 1.0, 1e-9 ) );
+    for ( uint32_t i=0; i<output.pixel_count(); ++i )
+    {
+        REQUIRE( output[i] <= 1.0 + 1e-9 );
+        REQUIRE( output[i] >= -1.0 - 1e-9 );
+    }
+
+    // normalizing the unnormalized plane gives the same result
+    gf_image raw{ fft.cross_correlate( a, b ) };
+    const double expected = output[ {3, 5} ];
+    REQUIRE_THAT( n( raw[ {3, 5} ] ), WithinAbs( expected, 1e-9 ) );
+
+    // windows without contrast map to zero
+    const zncc_normalization flat{ a.size(), sa.mean, 0.0, sb.mean, sb.stddev };
+    REQUIRE( flat( raw[ {16, 16} ] ) == 0.0 );
+}
+
 TEST_CASE("image_algos_test - auto_correlation_test")
 {
     // load images
@@ -214,3 +249,82 @@ TEST_CASE("image_algos_test - fft_real_test")
     REQUIRE( save_to_file( "fft_corr_a_output.pgm", gf_image{ output }) );
 }
 
+
+TEST_CASE("image_algos_test - padded_transform_test")
+{
+    gf_image window{ 16, 8 };
+    fill( window, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13) % 17; } );
+
+    // explicitly padded
+    gf_image padded{ 32, 32 };
+    for ( uint32_t h=0; h<window.height(); ++h )
+        for ( uint32_t w=0; w<window.width(); ++w )
+            padded[ {w, h} ] = window[ {w, h} ];
+
+    FFT fft( padded.size() );
+    const cf_image expected{ fft.transform( padded, direction::FORWARD ) };
+    const cf_image output{ fft.transform_padded( window ) };
+    for ( uint32_t i=0; i<output.pixel_count(); ++i )
+    {
+        REQUIRE_THAT( output[i].real, WithinAbs( expected[i].real, 1e-9 ) );
+        REQUIRE_THAT( output[i].imag, WithinAbs( expected[i].imag, 1e-9 ) );
+    }
+}
+
+TEST_CASE("image_algos_test - padded_cross_correlation_test")
+{
+    const size s{ 16, 16 };
+    gf_image a{ s };
+    gf_image b{ s };
+    fill( a, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13) % 17; } );
+    fill( b, []( uint32_t x, uint32_t y ){ return (x * 5 + y * 3) % 11; } );
+
+    constexpr uint32_t max_lag = 3;
+    FFT fft( { 32, 32 } );
+    const gf_image output{ fft.cross_correlate_padded( a, b, max_lag ) };
+    REQUIRE( output.size() == s );
+
+    // linear i.e. non-wrapping correlation, scaled by the padded area
+    for ( int32_t dy=-8; dy<8; ++dy )
+        for ( int32_t dx=-8; dx<8; ++dx )
+        {
+            double expected = 0;
+            if ( std::abs(dx) <= (int32_t)max_lag && std::abs(dy) <= (int32_t)max_lag )
+            {
+                for ( int32_t y=0; y<16; ++y )
+                    for ( int32_t x=0; x<16; ++x )
+                        if ( x + dx >= 0 && x + dx < 16 && y + dy >= 0 && y + dy < 16 )
+                            expected += a[ {(uint32_t)x, (uint32_t)y} ] * b[ {(uint32_t)(x + dx), (uint32_t)(y + dy)} ];
+                expected *= 32 * 32;
+            }
+
+            const double v = output[ {(uint32_t)(dx + 8), (uint32_t)(dy + 8)} ];
+            REQUIRE_THAT( v, WithinAbs( expected, 1e-6 ) );
+        }
+}
+
+TEST_CASE("image_algos_test - half_precision_cross_correlation_test")
+{
+    // values exactly representable in half precision correlate as
+    // their double precision equivalents
+    size s{ 64, 64 };
+    gf_image a{ s };
+    gf_image b{ s };
+    fill( a, []( uint32_t x, uint32_t y ){ return g_f( ( x*7 + y*3 ) % 11 ); } );
+    fill( b, []( uint32_t x, uint32_t y ){ return g_f( ( x*5 + y*3 + 2 ) % 11 ); } );
+
+    image< g_h > a_h{ a };
+    image< g_h > b_h{ b };
+    image< g_bf > a_bf{ a };
+    image< g_bf > b_bf{ b };
+
+    FFT fft( s );
+    const gf_image expected{ fft.cross_correlate( a, b ) };
+
+    const auto output = fft.cross_correlate( a_h, b_h );
+    STATIC_REQUIRE( std::is_same_v< decltype(output), const image< g<float> > > );
+    CHECK( gf_image{ output } == gf_image{ image< g<float> >{ expected } } );
+    CHECK( fft.cross_correlate_padded( a_h, b_h ) == fft.cross_correlate_padded( a, b ) );
+    CHECK( gf_image{ fft.cross_correlate_real( a_bf, b_bf ) } ==
+           gf_image{ image< g<float> >{ fft.cross_correlate_real( a, b ) } } );
+}
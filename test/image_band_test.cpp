@@ -0,0 +1,106 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "core/image.h"
+#include "core/image_band.h"
+#include "core/image_utils.h"
+#include "core/image_view.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+
+namespace {
+    g16_image make_frame( const size& s )
+    {
+        g16_image result{ s };
+        fill( result, []( uint32_t x, uint32_t y ){ return x + 1000 * y; } );
+        return result;
+    }
+}
+
+TEST_CASE("image_band_test - windows match extract")
+{
+    const g16_image frame{ make_frame( {64, 48} ) };
+    image_band<g_16> band{ frame };
+
+    const auto& b = band.load( 8, 16 );
+    REQUIRE( b.size() == size{ 64, 16 } );
+    REQUIRE( band.rect() == rect{ {0, 8}, {64, 16} } );
+    REQUIRE( band.rows_read() == 16 );
+
+    for ( int32_t x : { 0, 8, 16, 48 } )
+    {
+        const rect r{ {x, 8}, {16, 16} };
+        const auto copy = band.extract( r );
+        REQUIRE( copy == extract( frame, r ) );
+
+        const auto view = band.view( r );
+        REQUIRE( view.size() == r.size() );
+        for ( uint32_t h = 0; h < r.height(); ++h )
+            for ( uint32_t w = 0; w < r.width(); ++w )
+                REQUIRE( view[ {w, h} ] == frame[ {x + w, 8 + h} ] );
+    }
+}
+
+TEST_CASE("image_band_test - overlapping bands read each row once")
+{
+    const g16_image frame{ make_frame( {32, 64} ) };
+    image_band<g_16> band{ frame };
+
+    // 16 high windows at 50% overlap
+    for ( int32_t bottom = 0; bottom + 16 <= 64; bottom += 8 )
+    {
+        band.load( bottom, 16 );
+        const rect r{ {4, bottom}, {16, 16} };
+        REQUIRE( band.extract( r ) == extract( frame, r ) );
+    }
+    REQUIRE( band.rows_read() == 64 );
+
+    // reloading the same band reads nothing
+    band.load( 48, 16 );
+    REQUIRE( band.rows_read() == 64 );
+
+    // a disjoint band is read again
+    band.load( 0, 16 );
+    REQUIRE( band.rows_read() == 80 );
+}
+
+TEST_CASE("image_band_test - errors")
+{
+    const g16_image frame{ make_frame( {32, 32} ) };
+    image_band<g_16> band{ frame };
+
+    REQUIRE_THROWS( band.load( 24, 16 ) );
+    REQUIRE_THROWS( band.load( -1, 16 ) );
+
+    band.load( 0, 16 );
+    REQUIRE_THROWS( band.extract( rect{ {0, 8}, {16, 16} } ) );
+    REQUIRE_THROWS( band.view( rect{ {24, 0}, {16, 16} } ) );
+}
+
+TEST_CASE("image_band_test - moving down and resizing")
+{
+    const g16_image frame{ make_frame( {32, 64} ) };
+    image_band<g_16> band{ frame };
+
+    const auto check = [&]( int32_t bottom, uint32_t height )
+                       {
+                           band.load( bottom, height );
+                           REQUIRE( band.rect() == rect{ {0, bottom}, {32, height} } );
+                           const rect r{ {0, bottom}, {32, height} };
+                           REQUIRE( band.extract( r ) == extract( frame, r ) );
+                       };
+
+    check( 32, 16 );
+    check( 24, 16 );
+    check( 20, 24 );
+    check( 28, 8 );
+    check( 0, 64 );
+    REQUIRE( band.rows_read() == 16 + 8 + 8 + 0 + 56 );
+}
@@ -13,6 +13,7 @@
 // to be tested
 #include "core/image_expression.h"
 #include "core/image.h"
+#include "core/image_view.h"
 #include "core/image_utils.h"
 #include "algos/stats.h"
 
@@ -163,3 +164,52 @@ TEST_CASE("image_expression_test - scale_test")
     std::fstream os( "A_00001_a.pgm", std::ios_base::trunc | std::ios_base::out | std::ios_base::binary );
     writer->save( os, im );
 }
+
+TEST_CASE("image_expression_test - view_rows_test")
+{
+    gf_image a{ size{ 40, 30 }, image_layout::aligned };
+    fill( a, []( uint32_t x, uint32_t y ){ return x + 100 * y; } );
+    gf_image b{ 40, 30 };
+    fill( b, []( uint32_t x, uint32_t y ){ return 2 * x + y; } );
+
+    const rect r{ {5, 7}, {20, 10} };
+    const auto va = create_image_view( a, r );
+    const auto vb = create_image_view( b, r );
+
+    gf_image result{ va - vb * g_f{ 2 } + g_f{ 40 } };
+    REQUIRE( result.size() == r.size() );
+    for ( uint32_t y = 0; y < r.height(); ++y )
+        for ( uint32_t x = 0; x < r.width(); ++x )
+        {
+            const double ax = x + 5, ay = y + 7;
+            REQUIRE( result[ {x, y} ] == ( ax + 100 * ay ) - 2 * ( 2 * ax + ay ) + 40 );
+        }
+
+    // a row of an expression matches per-pixel evaluation
+    const cf_image ca{ a };
+    const cf_image cb{ b };
+    const auto e = conj( ca ) * cb;
+    const auto row = e.row( 3 );
+    for ( uint32_t x = 0; x < a.width(); ++x )
+        REQUIRE( ( row[x] == e[ 3 * a.width() + x ] ) );
+}
+
+TEST_CASE("image_expression_test - large_image_test")
+{
+    // large enough to be evaluated by several threads
+    g16_image a{ 1024, 1025 };
+    fill( a, []( uint32_t x, uint32_t y ){ return ( x + y ) % 1000; } );
+    g16_image b{ 1024, 1025, 7 };
+
+    g16_image result{ size{ 1, 1 }, image_layout::aligned };
+    result = a + b;
+    REQUIRE( result.size() == a.size() );
+    for ( uint32_t y = 0; y < a.height(); y += 7 )
+        for ( uint32_t x = 0; x < a.width(); ++x )
+            REQUIRE( result[ {x, y} ] == ( x + y ) % 1000 + 7 );
+    REQUIRE( result[ {1023, 1024} ] == ( 1023 + 1024 ) % 1000 + 7 );
+
+    // evaluation in place
+    result = result - b;
+    REQUIRE( result == a );
+}
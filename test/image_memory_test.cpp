@@ -0,0 +1,145 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "core/image.h"
+#include "core/image_memory.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+
+namespace {
+    /// resource counting the requests passed upstream
+    class counting_resource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations = 0;
+        size_t deallocations = 0;
+
+    private:
+        void* do_allocate( size_t bytes, size_t alignment ) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+        }
+
+        void do_deallocate( void* p, size_t bytes, size_t alignment ) override
+        {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+        }
+
+        bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST_CASE("image_memory_test - default resource is the pool")
+{
+    REQUIRE( default_image_resource() == image_pool_resource() );
+    REQUIRE( gf_image{ 8, 8 }.get_allocator().resource() == image_pool_resource() );
+}
+
+TEST_CASE("image_memory_test - pool reuses freed storage")
+{
+    image_pool_release();
+    const auto before = image_pool_thread_stats();
+    REQUIRE( before.cached_bytes == 0 );
+
+    const void* first = nullptr;
+    {
+        gf_image im{ 32, 32 };
+        first = im.data();
+        REQUIRE( reinterpret_cast<uintptr_t>( first ) % 64 == 0 );
+    }
+    REQUIRE( image_pool_thread_stats().cached_bytes > 0 );
+
+    // steady state: same size windows are served from the cache
+    for ( int i = 0; i < 10; ++i )
+    {
+        gf_image im{ 32, 32 };
+        REQUIRE( im.data() == first );
+    }
+
+    const auto after = image_pool_thread_stats();
+    REQUIRE( after.misses == before.misses + 1 );
+    REQUIRE( after.hits == before.hits + 10 );
+
+    image_pool_release();
+    REQUIRE( image_pool_thread_stats().cached_bytes == 0 );
+}
+
+TEST_CASE("image_memory_test - freed on another thread")
+{
+    image_pool_release();
+    gf_image im{ 64, 64 };
+    const auto misses = image_pool_thread_stats().misses;
+
+    std::thread t( [&]{ gf_image{}.swap( im ); } );
+    t.join();
+
+    // storage went to the other thread's cache, released at exit
+    REQUIRE( image_pool_thread_stats().cached_bytes == 0 );
+    gf_image again{ 64, 64 };
+    REQUIRE( image_pool_thread_stats().misses == misses + 1 );
+}
+
+TEST_CASE("image_memory_test - user supplied resource")
+{
+    counting_resource resource;
+    {
+        g16_image im{ size{ 16, 16 }, image_layout::aligned, &resource };
+        REQUIRE( im.get_allocator().resource() == &resource );
+        REQUIRE( resource.allocations == 1 );
+        REQUIRE( reinterpret_cast<uintptr_t>( im.data() ) % 64 == 0 );
+
+        // copies use the default resource; assignment keeps the resource
+        g16_image copy{ im };
+        REQUIRE( copy.get_allocator().resource() == default_image_resource() );
+        im = g16_image{ 16, 16, 3 };
+        REQUIRE( im.get_allocator().resource() == &resource );
+        REQUIRE( im == g16_image{ 16, 16, 3 } );
+
+        // swap across resources
+        g16_image other{ 4, 4, 7 };
+        swap( im, other );
+        REQUIRE( im == g16_image{ 4, 4, 7 } );
+        REQUIRE( other == g16_image{ 16, 16, 3 } );
+        REQUIRE( im.get_allocator().resource() == &resource );
+    }
+    REQUIRE( resource.allocations == resource.deallocations );
+
+    // an arena for short-lived images
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+    gf_image im{ size{ 16, 16 }, image_layout::packed, &arena };
+    REQUIRE( static_cast<void*>( im.data() ) >= static_cast<void*>( buffer.data() ) );
+    REQUIRE( static_cast<void*>( im.data() ) < static_cast<void*>( buffer.data() + buffer.size() ) );
+}
+
+TEST_CASE("image_memory_test - changing the default resource")
+{
+    counting_resource resource;
+    auto* previous = set_default_image_resource( &resource );
+    {
+        gf_image im{ 8, 8 };
+        REQUIRE( im.get_allocator().resource() == &resource );
+    }
+    REQUIRE( set_default_image_resource( previous ) == &resource );
+    REQUIRE( resource.allocations == 1 );
+    REQUIRE( resource.deallocations == 1 );
+    REQUIRE( default_image_resource() == image_pool_resource() );
+}
@@ -0,0 +1,191 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "core/image.h"
+#include "core/image_pyramid.h"
+#include "core/image_utils.h"
+#include "core/rect.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+
+namespace {
+    /// level \a l + 1 from level \a l by the definition of the filter
+    gf_image reference_downsample( const gf_image& in )
+    {
+        const int64_t w = in.width();
+        const int64_t h = in.height();
+        const auto at = [&]( int64_t x, int64_t y ) {
+            return in[ { static_cast<uint32_t>( std::clamp<int64_t>( x, 0, w - 1 ) ),
+                         static_cast<uint32_t>( std::clamp<int64_t>( y, 0, h - 1 ) ) } ].v;
+        };
+        const double k[] = { 1, 3, 3, 1 };
+
+        gf_image result{ static_cast<uint32_t>( w / 2 ), static_cast<uint32_t>( h / 2 ) };
+        for ( int64_t y = 0; y < h / 2; ++y )
+            for ( int64_t x = 0; x < w / 2; ++x )
+            {
+                double v = 0;
+                for ( int64_t j = 0; j < 4; ++j )
+                    for ( int64_t i = 0; i < 4; ++i )
+                        v += k[i] * k[j] * at( 2*x - 1 + i, 2*y - 1 + j );
+                result[ { static_cast<uint32_t>( x ), static_cast<uint32_t>( y ) } ] = v / 64;
+            }
+
+        return result;
+    }
+}
+
+TEST_CASE("image_pyramid_test - levels")
+{
+    image_pyramid<> pyramid{ g8_image{ 100, 50 } };
+    REQUIRE( pyramid.levels() == 6 );
+    CHECK( pyramid.level_size( 0 ) == size{ 100, 50 } );
+    CHECK( pyramid.level_size( 5 ) == size{ 3, 1 } );
+
+    // levels are computed on demand
+    CHECK( pyramid.is_computed( 0 ) );
+    CHECK( !pyramid.is_computed( 1 ) );
+    CHECK( pyramid.level( 3 ).size() == size{ 12, 6 } );
+    CHECK( pyramid.is_computed( 2 ) );
+    CHECK( !pyramid.is_computed( 4 ) );
+
+    _REQUIRE_THROWS_MATCHES( pyramid.level( 6 ), std::out_of_range, ContainsSubstring( "out of range" ) );
+
+    image_pyramid<> limited{ g8_image{ 100, 50 }, 2 };
+    CHECK( limited.levels() == 2 );
+
+    image_pyramid<> empty;
+    CHECK( empty.levels() == 0 );
+}
+
+TEST_CASE("image_pyramid_test - downsample")
+{
+    // odd sizes exercise the vectorized kernels, their tails and the
+    // dropped trailing row and column
+    gf_image im{ 77, 45 };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17 + 0.25 * x; } );
+
+    image_pyramid<> pyramid{ im };
+    image_pyramid< g<float> > float_pyramid{ im };
+    REQUIRE( pyramid.levels() == 6 );
+    REQUIRE( float_pyramid.levels() == 6 );
+
+    gf_image expected{ im };
+    bool result = true;
+    for ( uint32_t l = 1; l < pyramid.levels(); ++l )
+    {
+        expected = reference_downsample( expected );
+        const auto& level = pyramid[l];
+        const auto& float_level = float_pyramid[l];
+        REQUIRE( level.size() == expected.size() );
+        REQUIRE( float_level.size() == expected.size() );
+        for ( uint32_t i = 0; i < level.pixel_count(); ++i )
+        {
+            result &= std::abs( level[i].v - expected[i].v ) < 1e-12;
+            result &= std::abs( float_level[i].v - expected[i].v ) < 1e-4;
+        }
+    }
+    CHECK( result );
+}
+
+TEST_CASE("image_pyramid_test - anti-aliasing")
+{
+    // a checkerboard is at the Nyquist frequency and must not alias
+    // into a pattern at the coarser level
+    gf_image im{ 64, 64 };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x + y ) % 2; } );
+
+    image_pyramid<> pyramid{ im };
+    const auto& level = pyramid[1];
+    bool result = true;
+    for ( uint32_t y = 1; y < level.height() - 1; ++y )
+        for ( uint32_t x = 1; x < level.width() - 1; ++x )
+            result &= std::abs( level[ {x, y} ].v - 0.5 ) < 1e-6;
+    CHECK( result );
+}
+
+TEST_CASE("image_pyramid_test - buffer reuse")
+{
+    gf_image im{ 64, 32 };
+    fill( im, []( uint32_t x, uint32_t y ){ return x + y; } );
+
+    image_pyramid<> pyramid{ im };
+    const auto* data = pyramid[2].data();
+
+    fill( im, []( uint32_t x, uint32_t y ){ return 2.0 * ( x + y ); } );
+    pyramid.assign( im );
+    CHECK( !pyramid.is_computed( 1 ) );
+    CHECK( pyramid[2].data() == data );
+    CHECK( pyramid[2] == reference_downsample( reference_downsample( im ) ) );
+
+    // a shared base isn't copied
+    gf_image shared{ im };
+    shared.share();
+    pyramid.assign( shared );
+    CHECK( pyramid[0].data() == std::as_const( shared ).data() );
+}
+
+TEST_CASE("image_pyramid_test - coordinate mapping")
+{
+    CHECK( pyramid_scale( 0, 2 ) == 0.25 );
+    CHECK( pyramid_scale( 3, 1 ) == 4 );
+
+    // pixel centres
+    CHECK( map_to_level( point2<double>{ 0.5, 0.5 }, 0, 1 ) == point2<double>{ 0, 0 } );
+    CHECK( map_to_level( point2<double>{ 3, 5 }, 1, 0 ) == point2<double>{ 6.5, 10.5 } );
+    CHECK( map_to_level( map_to_level( point2<double>{ 17.25, 3.75 }, 0, 3 ), 3, 0 ) == point2<double>{ 17.25, 3.75 } );
+
+    // rectangles: finer is exact, coarser covers
+    CHECK( map_to_level( rect{ { 2, 3 }, { 8, 4 } }, 1, 0 ) == rect{ { 4, 6 }, { 16, 8 } } );
+    CHECK( map_to_level( rect{ { 5, 3 }, { 6, 4 } }, 0, 1 ) == rect{ { 2, 1 }, { 4, 3 } } );
+    CHECK( map_to_level( rect{ { -3, 0 }, { 2, 2 } }, 0, 1 ) == rect{ { -2, 0 }, { 2, 1 } } );
+
+    // a grid generated at a coarse level maps to areas of the base
+    // with the same relative coverage
+    image_pyramid<> pyramid{ gf_image{ 256, 128 } };
+    const auto coarse = pyramid.grid( 2, { 16, 16 }, 0.5 );
+    const auto fine = map_to_level( coarse, 2, 0 );
+    REQUIRE( fine.size() == coarse.size() );
+    REQUIRE( !fine.empty() );
+    const auto base_rect = rect::from_size( pyramid.base_size() );
+    bool result = true;
+    for ( size_t i = 0; i < fine.size(); ++i )
+    {
+        result &= fine[i].size() == size{ 64, 64 };
+        result &= fine[i].bottomLeft() == rect::point_t{ coarse[i].left() * 4, coarse[i].bottom() * 4 };
+        result &= base_rect.contains( fine[i] );
+    }
+    CHECK( result );
+    CHECK( map_to_level( fine, 0, 2 ) == coarse );
+
+    _REQUIRE_THROWS_MATCHES( pyramid.grid( 8, { 16, 16 }, 0.5 ), std::out_of_range, ContainsSubstring( "out of range" ) );
+}
+
+TEST_CASE("image_pyramid_test - feature position")
+{
+    // a symmetric blob centred between pixels of the base is centred
+    // on a pixel of level 1, as given by map_to_level
+    const point2<double> centre{ 64.5, 40.5 };
+    gf_image im{ 128, 96 };
+    fill( im, [&centre]( uint32_t x, uint32_t y ){
+        const double dx = x - centre[0], dy = y - centre[1];
+        return std::exp( -( dx*dx + dy*dy ) / 32 ); } );
+
+    image_pyramid<> pyramid{ im };
+    const auto& level = pyramid[1];
+    const auto peak = std::max_element( std::begin( level ), std::end( level ) ) - std::begin( level );
+    const auto expected = map_to_level( centre, 0, 1 );
+    CHECK( static_cast<double>( peak % level.width() ) == expected[0] );
+    CHECK( static_cast<double>( peak / level.width() ) == expected[1] );
+}
@@ -1,14 +1,21 @@
 
 // catch
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cmath>
 
 // local
 #include "test_utils.h"
 
 // to be tested
+#include "core/image_utils.h"
+#include "core/image_view.h"
 #include "core/pixel_types.h"
 #include "algos/stats.h"
 
+using namespace Catch::Matchers;
 using namespace openpiv::core;
 using namespace openpiv::algos;
 
@@ -56,3 +63,65 @@ TEST_CASE("image_stats_test - find_image_range_min_max_test")
     REQUIRE(max == 255);
 }
 
+
+TEST_CASE("image_stats_test - reduce_expression_test")
+{
+    gf_image a{ 37, 23 };
+    fill( a, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 3 ) % 11; } );
+    gf_image b{ 37, 23 };
+    fill( b, []( uint32_t x, uint32_t y ){ return ( x + y ) % 5; } );
+
+    // reference from the materialized expression
+    const gf_image d{ a - b };
+    double sum = 0, sum_sqr = 0, lo = d[0], hi = d[0];
+    for ( const auto& p : d )
+    {
+        sum += p;
+        sum_sqr += p * p;
+        lo = std::min<double>( lo, p );
+        hi = std::max<double>( hi, p );
+    }
+
+    const auto [ mn, mx, total ] = reduce< min_reduction, max_reduction, sum_reduction >( a - b );
+    REQUIRE( mn == lo );
+    REQUIRE( mx == hi );
+    REQUIRE_THAT( total, WithinAbs( sum, 1e-9 ) );
+
+    REQUIRE_THAT( image_sum( a - b ), WithinAbs( sum, 1e-9 ) );
+    REQUIRE_THAT( image_mean( a - b ), WithinAbs( sum / d.pixel_count(), 1e-12 ) );
+    REQUIRE_THAT( image_norm( a - b ), WithinAbs( std::sqrt( sum_sqr ), 1e-9 ) );
+    REQUIRE( image_min_max( d ) == std::make_tuple( g_f{ lo }, g_f{ hi } ) );
+}
+
+TEST_CASE("image_stats_test - reduce_image_types_test")
+{
+    g16_image im{ 64, 48 };
+    fill( im, []( uint32_t x, uint32_t y ){ return x * y; } );
+    const auto view = create_image_view( im, rect{ {10, 5}, {20, 30} } );
+
+    // integers are summed exactly
+    REQUIRE( image_sum( im ) == pixel_sum( im ) );
+    REQUIRE( image_sum( view ) == pixel_sum( view ) );
+    REQUIRE( image_min_max( view ) == std::make_tuple( g_16{ 50 }, g_16{ 29 * 34 } ) );
+
+    cf_image c{ 8, 8, c_f{ 3, 4 } };
+    c[ {2, 2} ] = c_f{ 0, 1 };
+    REQUIRE( image_sum( c ) == complex<double>{ 63 * 3.0, 63 * 4.0 + 1 } );
+    REQUIRE_THAT( image_norm( c ), WithinAbs( std::sqrt( 63 * 25.0 + 1 ), 1e-12 ) );
+    REQUIRE( std::get<0>( image_min_max( c ) ) == c_f{ 0, 1 } );
+
+    // empty images reduce to empty results
+    REQUIRE( image_sum( g16_image{} ) == 0 );
+}
+
+TEST_CASE("image_stats_test - reduce_large_accuracy_test")
+{
+    // large enough to be reduced by several threads; values which
+    // lose precision when naively summed into one double
+    gf_image im{ 1024, 1024, g_f{ 0.1 } };
+    im[0] = 1e8;
+
+    REQUIRE_THAT( image_sum( im ), WithinAbs( 1e8 + 0.1 * ( im.pixel_count() - 1 ), 1e-6 ) );
+    REQUIRE_THAT( image_sum( im - im ), WithinAbs( 0.0, 0 ) );
+    REQUIRE( std::get<1>( image_min_max( im + im ) ) == 2e8 );
+}
@@ -10,6 +10,8 @@
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 // local
 #include "test_utils.h"
@@ -82,12 +84,28 @@ TEST_CASE("image_test - move_test")
     std::tie( im, v ) = create_and_fill( {200, 100}, 128_g8 );
 
     g8_image im2{ std::move(im) };
+    REQUIRE( im2.size() == size{ 200, 100 } );
 
     bool result = true;
-    for ( uint32_t i=0; i<im.pixel_count(); ++i )
+    for ( uint32_t i=0; i<im2.pixel_count(); ++i )
         result &= (im2[i] == v);
 
     REQUIRE( result );
+
+    // the moved-from image is empty and reusable without touching
+    // the pixels it gave up
+    REQUIRE( im.size() == size{} );
+    REQUIRE( im.data() == nullptr );
+    im.resize( {200, 100} );
+    im[0] = 0;
+    REQUIRE( im2[0] == v );
+
+    g8_image im3;
+    im3 = std::move(im2);
+    REQUIRE( im2.size() == size{} );
+    im2.resize( {200, 100} );
+    im2[0] = 1;
+    REQUIRE( im3[0] == v );
 }
 
 TEST_CASE("image_test - convert_test")
@@ -235,3 +253,321 @@ TEST_CASE("image_test - iterator_test")
         REQUIRE( *im.line(h) == h*100 );
 }
 
+
+TEST_CASE("image_test - aligned_layout_test")
+{
+    g16_image im{ size{ 100, 10 }, image_layout::aligned };
+    REQUIRE( im.layout() == image_layout::aligned );
+    REQUIRE( im.pitch() == 128 );
+    REQUIRE( !im.is_packed() );
+    REQUIRE( im.stride() == std::tuple<size_t, size_t>{ 2, 256 } );
+    for ( uint32_t h=0; h<im.height(); ++h )
+        REQUIRE( reinterpret_cast<uintptr_t>( im.line(h) ) % 64 == 0 );
+
+    // power-of-two strides are avoided
+    REQUIRE( g16_image::pitch_for( 2048, image_layout::aligned ) == 2048 + 32 );
+    REQUIRE( g16_image::pitch_for( 2048, image_layout::packed ) == 2048 );
+
+    // iterators, linear & point indices skip padding
+    std::iota( std::begin( im ), std::end( im ), 0 );
+    REQUIRE( std::distance( im.begin(), im.end() ) == 1000 );
+    for ( uint32_t h=0; h<im.height(); ++h )
+    {
+        REQUIRE( im.line(h)[0] == h*100 );
+        REQUIRE( im[ {99, h} ] == h*100 + 99 );
+        REQUIRE( im[ h*100 + 5 ] == h*100 + 5 );
+    }
+
+    // equality is independent of layout
+    g16_image packed{ im.size() };
+    std::iota( std::begin( packed ), std::end( packed ), 0 );
+    REQUIRE( packed == im );
+
+    // copies keep the layout, conversions are packed
+    g16_image copy{ im };
+    REQUIRE( copy.pitch() == 128 );
+    REQUIRE( copy == im );
+    gf_image converted{ im };
+    REQUIRE( converted.is_packed() );
+    REQUIRE( converted[ 105 ] == 105 );
+
+    // resize keeps the layout
+    im.resize( 30, 4 );
+    REQUIRE( im.pitch() == 32 );
+}
+
+TEST_CASE("image_test - aligned_view_test")
+{
+    gf_image im{ size{ 20, 20 }, image_layout::aligned };
+    std::iota( std::begin( im ), std::end( im ), 0 );
+
+    auto view = create_image_view( im, rect{ {2, 3}, {8, 8} } );
+    REQUIRE( view.stride() == im.stride() );
+    REQUIRE( view[ {1, 1} ] == 4 * 20 + 3 );
+    REQUIRE( view.line(1)[1] == 4 * 20 + 3 );
+    REQUIRE( extract( im, rect{ {2, 3}, {8, 8} } ) == gf_image{ view } );
+
+    // expressions evaluate into aligned images
+    gf_image doubled{ size{ 20, 20 }, image_layout::aligned };
+    doubled = im + im;
+    REQUIRE( doubled.pitch() == im.pitch() );
+    REQUIRE( doubled[ {19, 19} ] == 2 * 399 );
+}
+
+TEST_CASE("image_test - wrapped_image_test")
+{
+    // 5x4 pixels in rows of 8 in external memory
+    std::vector<g_16> memory( 8 * 4, g_16{ 0 } );
+    for ( uint32_t y = 0; y < 4; ++y )
+        for ( uint32_t x = 0; x < 5; ++x )
+            memory[ y * 8 + x ] = g_16{ 10 * y + x };
+
+    auto im = g16_image::wrap( memory.data(), size{ 5, 4 }, 8 );
+    REQUIRE( im.is_wrapped() );
+    REQUIRE( im.data() == memory.data() );
+    REQUIRE( im.pitch() == 8 );
+    REQUIRE( im[ {3, 2} ] == 23 );
+    REQUIRE( std::get<1>( im.stride() ) == 8 * sizeof(g_16) );
+
+    // writes go to the external memory
+    im[ {4, 3} ] = 99;
+    REQUIRE( memory[ 3 * 8 + 4 ] == 99 );
+
+    // copies own their pixels
+    g16_image copy{ im };
+    REQUIRE( !copy.is_wrapped() );
+    REQUIRE( copy.data() != memory.data() );
+    REQUIRE( copy == im );
+
+    // views, extract and expressions work in place
+    auto view = create_image_view( im, rect{ {1, 1}, {3, 2} } );
+    REQUIRE( view[ {0, 0} ] == 11 );
+    REQUIRE( extract( im, rect{ {1, 1}, {3, 2} } ) == g16_image{ view } );
+    im = im + im;
+    REQUIRE( im.is_wrapped() );
+    REQUIRE( memory[ 2 * 8 + 3 ] == 46 );
+    REQUIRE( memory[ 2 * 8 + 5 ] == 0 );
+
+    // read-only memory
+    const std::vector<g_f> constant( 16, g_f{ 2 } );
+    auto cim = gf_image::wrap( constant.data(), size{ 4, 4 } );
+    static_assert( std::is_same_v< decltype( cim.data() ), const g_f* > );
+    static_assert( std::is_same_v< decltype( cim[0] ), const g_f& > );
+    REQUIRE( cim.is_wrapped() );
+    REQUIRE( cim.is_packed() );
+    REQUIRE( cim.data() == constant.data() );
+    REQUIRE( cim[ {3, 3} ] == 2 );
+    const gf_image& cref = cim;
+    REQUIRE( cref.data() == constant.data() );
+    REQUIRE( gf_image{ cim } == cref );
+    const auto moved = std::move( cim );
+    REQUIRE( moved.data() == constant.data() );
+
+    // resizing detaches
+    im.resize( 2, 2 );
+    REQUIRE( !im.is_wrapped() );
+    REQUIRE( im.data() != memory.data() );
+
+    REQUIRE_THROWS( g16_image::wrap( memory.data(), size{ 5, 4 }, 4 ) );
+    REQUIRE_THROWS( g16_image::wrap( static_cast<g_16*>( nullptr ), size{ 5, 4 } ) );
+}
+
+TEST_CASE("image_test - shared_image_test")
+{
+    gf_image im{ 6, 4 };
+    fill( im, []( uint32_t x, uint32_t y ){ return 10 * y + x; } );
+    REQUIRE( !im.is_shared() );
+    REQUIRE( im.share_count() == 1 );
+
+    // sharing keeps the pixels in place
+    const g_f* pixels = std::as_const( im ).data();
+    im.share();
+    REQUIRE( im.is_shared() );
+    REQUIRE( std::as_const( im ).data() == pixels );
+
+    // copies share pixels, including copies of copies and extract
+    // of the whole image
+    const gf_image copy{ im };
+    gf_image copy_of_copy;
+    copy_of_copy = copy;
+    const gf_image whole = extract( im, rect::from_size( im.size() ) );
+    REQUIRE( copy.is_shared() );
+    REQUIRE( copy.data() == pixels );
+    REQUIRE( std::as_const( copy_of_copy ).data() == pixels );
+    REQUIRE( whole.data() == pixels );
+    REQUIRE( im.share_count() == 4 );
+
+    // reading doesn't copy, including through a const view
+    const auto view = create_image_view( copy_of_copy, rect{ {1, 1}, {3, 2} } );
+    REQUIRE( view[ {0, 0} ] == 11 );
+    REQUIRE( *view.begin() == 11 );
+    REQUIRE( std::as_const( copy_of_copy ).data() == pixels );
+
+    // writing copies
+    copy_of_copy[ {0, 0} ] = 99;
+    REQUIRE( copy_of_copy.data() != pixels );
+    REQUIRE( copy_of_copy.is_shared() );
+    REQUIRE( copy_of_copy.share_count() == 1 );
+    REQUIRE( copy_of_copy[ {0, 0} ] == 99 );
+    REQUIRE( copy_of_copy[ {5, 3} ] == 35 );
+    REQUIRE( copy[ {0, 0} ] == 0 );
+    REQUIRE( im.share_count() == 3 );
+
+    // as does assigning an expression, which may read the image
+    im = im + im;
+    REQUIRE( im[ {5, 3} ] == 70 );
+    REQUIRE( copy[ {5, 3} ] == 35 );
+    REQUIRE( whole[ {5, 3} ] == 35 );
+    REQUIRE( copy.share_count() == 2 );
+
+    // the last image sharing pixels writes in place
+    gf_image last{ std::move( copy_of_copy ) };
+    const g_f* last_pixels = std::as_const( last ).data();
+    last[ {1, 1} ] = 7;
+    REQUIRE( last.data() == last_pixels );
+
+    // copies of images that aren't shared are deep
+    gf_image deep{ 2, 2 };
+    gf_image deep_copy{ deep };
+    REQUIRE( !deep_copy.is_shared() );
+    REQUIRE( std::as_const( deep_copy ).data() != std::as_const( deep ).data() );
+
+    // wrapped images take a copy of their memory
+    std::vector<g_16> memory( 4, g_16{ 3 } );
+    auto wrapped = g16_image::wrap( memory.data(), size{ 2, 2 } );
+    wrapped.share();
+    REQUIRE( !wrapped.is_wrapped() );
+    REQUIRE( wrapped.is_shared() );
+    REQUIRE( std::as_const( wrapped ).data() != memory.data() );
+    REQUIRE( wrapped[ {1, 1} ] == 3 );
+
+    // resizing allocates new shared pixels
+    gf_image resized{ im };
+    resized.resize( 3, 3 );
+    REQUIRE( resized.is_shared() );
+    REQUIRE( resized.share_count() == 1 );
+    REQUIRE( im.share_count() == 1 );
+}
+
+TEST_CASE("image_test - wrapped_image_save_load_test")
+{
+    std::vector<g_16> source( 6 * 3 );
+    std::iota( std::begin( source ), std::end( source ), 100 );
+    const auto im = g16_image::wrap( source.data(), size{ 5, 3 }, 6 );
+
+    std::shared_ptr<image_loader> writer{ image_loader_registry::instance().find("image/x-portable-anymap") };
+    REQUIRE(!!writer);
+    std::stringstream ss;
+    writer->save( ss, im );
+
+    g16_image loaded;
+    std::shared_ptr<image_loader> reader{ image_loader_registry::instance().find( ss ) };
+    REQUIRE(!!reader);
+    reader->load( ss, loaded );
+    REQUIRE( loaded == g16_image{ im } );
+    REQUIRE( loaded[ {1, 1} ] == 107 );
+}
+
+namespace {
+
+    /// fill \a im with pseudo-random pixels covering the full range
+    /// of each channel
+    template < typename T >
+    void fill_random( image<T>& im, uint32_t seed )
+    {
+        for ( auto& p : im )
+        {
+            seed = seed * 1664525u + 1013904223u;
+            if constexpr ( is_real_mono_pixeltype_v<T> )
+                p = T( seed >> 16 );
+            else
+                p = T( seed >> 24, seed >> 16, seed >> 8, seed );
+        }
+    }
+
+    /// \returns true if converting \a from to \a To by image
+    /// assignment, as a view, and row by row with non-temporal stores
+    /// at each output alignment, matches the scalar convert()
+    template < typename To, typename From >
+    bool conversion_matches( const image<From>& from )
+    {
+        const auto expected = [&from]( size_t i ){ To result; convert( from[i], result ); return result; };
+
+        image<To> assigned;
+        assigned = from;
+        for ( size_t i=0; i<from.pixel_count(); ++i )
+            if ( !( assigned[i] == expected( i ) ) )
+                return false;
+
+        const auto view = create_image_view( from, rect{ {1, 1}, {from.width() - 2, from.height() - 2} } );
+        image<To> from_view;
+        from_view = view;
+        for ( uint32_t h=0; h<view.height(); ++h )
+            for ( uint32_t w=0; w<view.width(); ++w )
+            {
+                To e; convert( view[ {w, h} ], e );
+                if ( !( from_view[ {w, h} ] == e ) )
+                    return false;
+            }
+
+        std::vector<To> streamed( from.pixel_count() + 8 );
+        for ( size_t offset=0; offset<4; ++offset )
+        {
+            openpiv::core::detail::convert_row( from.data(), streamed.data() + offset, from.pixel_count(), true );
+            for ( size_t i=0; i<from.pixel_count(); ++i )
+                if ( !( streamed[offset + i] == expected( i ) ) )
+                    return false;
+        }
+
+        return true;
+    }
+
+}
+
+TEST_CASE("image_test - vectorized_conversion_test")
+{
+    for ( uint32_t width : { 3u, 8u, 9u, 17u, 35u } )
+    {
+        g8_image g8{ width, 5 };
+        g16_image g16{ width, 5 };
+        rgba8_image rgba8{ width, 5 };
+        rgba16_image rgba16{ width, 5 };
+        fill_random( g8, width );
+        fill_random( g16, width + 1 );
+        fill_random( rgba8, width + 2 );
+        fill_random( rgba16, width + 3 );
+
+        CHECK( conversion_matches< g_f >( g8 ) );
+        CHECK( conversion_matches< g_f >( g16 ) );
+        CHECK( conversion_matches< g<float> >( g8 ) );
+        CHECK( conversion_matches< g<float> >( g16 ) );
+        CHECK( conversion_matches< c_f >( g16 ) );
+        CHECK( conversion_matches< g_8 >( rgba8 ) );
+        CHECK( conversion_matches< g_16 >( rgba8 ) );
+        CHECK( conversion_matches< g_f >( rgba8 ) );
+        CHECK( conversion_matches< g_16 >( rgba16 ) );
+        CHECK( conversion_matches< g_f >( rgba16 ) );
+        CHECK( conversion_matches< g_8 >( rgba16 ) );
+
+        gf_image gf{ width, 5 };
+        fill_random( gf, width + 4 );
+        for ( auto& p : gf )
+            p = p * 1.000123 - 20000;
+        image< g<float> > gfloat{ gf };
+        image< g_h > gh{ gf };
+        image< g_bf > gbf{ gf };
+
+        CHECK( conversion_matches< g_f >( gh ) );
+        CHECK( conversion_matches< g<float> >( gh ) );
+        CHECK( conversion_matches< c_f >( gh ) );
+        CHECK( conversion_matches< g_h >( gf ) );
+        CHECK( conversion_matches< g_h >( gfloat ) );
+        CHECK( conversion_matches< g_h >( g16 ) );
+        CHECK( conversion_matches< g_f >( gbf ) );
+        CHECK( conversion_matches< g<float> >( gbf ) );
+        CHECK( conversion_matches< c_f >( gbf ) );
+        CHECK( conversion_matches< g_bf >( gf ) );
+        CHECK( conversion_matches< g_bf >( gfloat ) );
+        CHECK( conversion_matches< g_bf >( g16 ) );
+    }
+}
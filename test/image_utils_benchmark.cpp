@@ -3,7 +3,13 @@
 #include <benchmark/benchmark.h>
 
 // openpiv
+#include "core/image_band.h"
+#include "core/image_memory.h"
+#include "core/image_pyramid.h"
 #include "core/image_utils.h"
+#include "core/split_complex_image.h"
+#include "core/summed_area_table.h"
+#include "algos/stats.h"
 #include "loaders/image_loader.h"
 
 // test
@@ -32,4 +38,263 @@ BENCHMARK_TEMPLATE(transpose_benchmark, rgba8_image)->Threads(2)->RangeMultiplie
 BENCHMARK_TEMPLATE(transpose_benchmark, rgba16_image)->Threads(2)->RangeMultiplier(2)->Range(2, 1024);
 BENCHMARK_TEMPLATE(transpose_benchmark, cf_image)->Threads(2)->RangeMultiplier(2)->Range(2, 1024);
 
+template <typename ImageT>
+static void summed_area_table_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ d, d };
+    ImageT im{ s };
+
+    for (auto _ : state)
+    {
+        auto sat{ make_summed_area_table(im) };
+        benchmark::DoNotOptimize(sat);
+    }
+}
+
+BENCHMARK_TEMPLATE(summed_area_table_benchmark, g8_image)->RangeMultiplier(2)->Range(64, 4096);
+BENCHMARK_TEMPLATE(summed_area_table_benchmark, g16_image)->RangeMultiplier(2)->Range(64, 4096);
+BENCHMARK_TEMPLATE(summed_area_table_benchmark, gf_image)->RangeMultiplier(2)->Range(64, 4096);
+
+template <typename ImageT>
+static void grid_extract_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ 2048, 2048 };
+    ImageT im{ s };
+
+    for (auto _ : state)
+    {
+        // 50% overlap
+        for ( uint32_t y = 0; y + d <= s.height(); y += d/2 )
+            for ( uint32_t x = 0; x + d <= s.width(); x += d/2 )
+                benchmark::DoNotOptimize( extract( im, rect{ {(int32_t)x, (int32_t)y}, {d, d} } ) );
+    }
+}
+
+template <typename ImageT>
+static void grid_band_extract_benchmark(benchmark::State& state)
+{
+    using pixel_t = typename ImageT::pixel_t;
+    uint32_t d{ (uint32_t)state.range(0) };
+    size s{ 2048, 2048 };
+    ImageT im{ s };
+
+    for (auto _ : state)
+    {
+        // 50% overlap
+        image_band<pixel_t> band{ im };
+        for ( uint32_t y = 0; y + d <= s.height(); y += d/2 )
+        {
+            band.load( y, d );
+            for ( uint32_t x = 0; x + d <= s.width(); x += d/2 )
+                benchmark::DoNotOptimize( band.extract( rect{ {(int32_t)x, (int32_t)y}, {d, d} } ) );
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(grid_extract_benchmark, gf_image)->RangeMultiplier(2)->Range(16, 64);
+BENCHMARK_TEMPLATE(grid_band_extract_benchmark, gf_image)->RangeMultiplier(2)->Range(16, 64);
+
+template <typename ImageT>
+static void pixel_sum_view_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    ImageT im{ d + 16, d + 16 };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x + y ) % 7; } );
+    const auto view = create_image_view( im, rect{ {8, 8}, {d, d} } );
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize( pixel_sum( view ) );
+    }
+}
+
+BENCHMARK_TEMPLATE(pixel_sum_view_benchmark, g16_image)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(pixel_sum_view_benchmark, gf_image)->RangeMultiplier(4)->Range(16, 1024);
+
+template <typename ImageT>
+static void frame_expression_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    ImageT avg{ d, d };
+    ImageT im{ d, d };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x + y ) % 7; } );
+
+    for (auto _ : state)
+    {
+        avg = avg + im;
+        benchmark::DoNotOptimize( avg.data() );
+    }
+    state.SetBytesProcessed( state.iterations() * 3 * im.pixel_count() * sizeof(typename ImageT::pixel_t) );
+}
+
+BENCHMARK_TEMPLATE(frame_expression_benchmark, g16_image)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(frame_expression_benchmark, gf_image)->RangeMultiplier(4)->Range(256, 4096);
+
+template <typename ImageT>
+static void fused_reduce_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    ImageT a{ d, d };
+    ImageT b{ d, d };
+    fill( a, []( uint32_t x, uint32_t y ){ return ( x + y ) % 7; } );
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            openpiv::algos::reduce< openpiv::algos::min_reduction,
+                                    openpiv::algos::max_reduction,
+                                    openpiv::algos::sum_reduction >( a - b ) );
+    }
+}
+
+BENCHMARK_TEMPLATE(fused_reduce_benchmark, gf_image)->RangeMultiplier(4)->Range(64, 4096);
+
+template <typename ImageT>
+static void window_allocation_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    std::pmr::memory_resource* resource =
+        state.range(1) ? image_pool_resource() : std::pmr::new_delete_resource();
+
+    for (auto _ : state)
+    {
+        ImageT im{ size{ d, d }, image_layout::packed, resource };
+        benchmark::DoNotOptimize( im.data() );
+    }
+}
+
+BENCHMARK_TEMPLATE(window_allocation_benchmark, gf_image)->Threads(4)->ArgsProduct({ {16, 32, 64, 128}, {0, 1} });
+
+template <typename FromT, typename ToT>
+static void pixel_conversion_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    FromT from{ d, d };
+    ToT to{ d, d };
+
+    for (auto _ : state)
+    {
+        to = from;
+        benchmark::DoNotOptimize( to.data() );
+    }
+    state.SetBytesProcessed( state.iterations() * from.pixel_count() * sizeof(typename ToT::pixel_t) );
+}
+
+BENCHMARK_TEMPLATE(pixel_conversion_benchmark, g8_image, gf_image)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(pixel_conversion_benchmark, g16_image, gf_image)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(pixel_conversion_benchmark, rgba8_image, g8_image)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(pixel_conversion_benchmark, rgba16_image, gf_image)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(pixel_conversion_benchmark, g16_image, cf_image)->RangeMultiplier(4)->Range(64, 4096);
+
+template <typename ImageT>
+static void peak_find_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    ImageT im{ d, d };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17; } );
+
+    for (auto _ : state)
+    {
+        if ( state.range(1) )
+            benchmark::DoNotOptimize( find_fixed_peaks<1>( im, 2 ) );
+        else
+            benchmark::DoNotOptimize( find_peaks( im, 2, 1 ) );
+    }
+}
+
+BENCHMARK_TEMPLATE(peak_find_benchmark, gf_image)->ArgsProduct({ {32, 64, 128}, {0, 1} });
+
+/// Gaussian blur of a frame by convolution (0), recursively (1) and
+/// a box blur (2) of the same radius
+template <typename ImageT>
+static void blur_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    const double sigma = state.range(1);
+    ImageT im{ d, d };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17; } );
+
+    for (auto _ : state)
+    {
+        switch ( state.range(2) )
+        {
+        case 0: benchmark::DoNotOptimize( gaussian_blur( im, sigma ) ); break;
+        case 1: benchmark::DoNotOptimize( recursive_gaussian_blur( im, sigma ) ); break;
+        default: benchmark::DoNotOptimize( box_blur( im, 3 * sigma ) ); break;
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(blur_benchmark, g16_image)->ArgsProduct({ {1024, 2048}, {1, 4, 16}, {0, 1, 2} })->Unit(benchmark::kMillisecond);
+
+/// rebuild all levels of a pyramid of a frame, reusing its storage
+template <typename PixelT>
+static void pyramid_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    g16_image im{ d, d };
+    fill( im, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17; } );
+
+    image_pyramid<PixelT> pyramid;
+    for (auto _ : state)
+    {
+        pyramid.assign( im );
+        benchmark::DoNotOptimize( pyramid[ pyramid.levels() - 1 ].data() );
+    }
+}
+
+BENCHMARK_TEMPLATE(pyramid_benchmark, g<float>)->Arg(1024)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(pyramid_benchmark, g_f)->Arg(1024)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+/// copy of a frame with deep (0) or shared (1) storage
+template <typename ImageT>
+static void image_copy_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    ImageT im{ d, d };
+    if ( state.range(1) )
+        im.share();
+
+    for (auto _ : state)
+    {
+        ImageT copy{ im };
+        benchmark::DoNotOptimize( copy );
+    }
+}
+
+BENCHMARK_TEMPLATE(image_copy_benchmark, g16_image)->ArgsProduct({ {256, 1024, 4096}, {0, 1} });
+
+/// cross spectrum and its magnitude from interleaved (0) and split (1)
+/// complex spectra
+static void spectrum_layout_benchmark(benchmark::State& state)
+{
+    uint32_t d{ (uint32_t)state.range(0) };
+    cf_image a{ d, d };
+    cf_image b{ d, d };
+    fill( a, []( uint32_t x, uint32_t y ){ return c_f( x % 7, y % 5 ); } );
+    fill( b, []( uint32_t x, uint32_t y ){ return c_f( y % 3, x % 11 ); } );
+    const split_cf_image split_a{ a };
+    const split_cf_image split_b{ b };
+
+    cf_image product{ a.size() };
+    split_cf_image split_product{ a.size() };
+    for (auto _ : state)
+    {
+        if ( state.range(1) )
+        {
+            conj_multiply( split_a, split_b, split_product );
+            benchmark::DoNotOptimize( abs_sqr( split_product ).data() );
+        }
+        else
+        {
+            product = b * conj( a );
+            benchmark::DoNotOptimize( cf_image{ abs_sqr( product ) }.data() );
+        }
+    }
+}
+
+BENCHMARK(spectrum_layout_benchmark)->ArgsProduct({ {32, 64, 128, 256}, {0, 1} });
+
 BENCHMARK_MAIN();
@@ -395,3 +395,165 @@ TEST_CASE("image_utils_test - extract_image_view_test")
     REQUIRE( pixel_sum( c1 ) == 1 * c1.pixel_count() );
     REQUIRE( pixel_sum( c2 ) == 1 * c2.pixel_count() );
 }
+
+TEST_CASE("image_utils_test - fixed_peak_find_test")
+{
+    rect::point_t o{ 10, 10 };
+    gf_image im{ rect( o, size{ 100, 100 } ), 1.0 };
+
+    // add some peaks
+    im[ {20, 20} ] = 20.0;
+    im[ {30, 30} ] = 30.0;
+    im[ {40, 40} ] = 40.0;
+    im[ {50, 50} ] = 50.0;
+    im[ {51, 61} ] = 25.0;
+    im[ {50, 51} ] = 10.0;
+
+    // find the peaks - in order, and the same as find_peaks
+    auto views{ find_peaks( im, 3, 1 ) };
+    auto peaks{ find_fixed_peaks<1>( im, 3 ) };
+    STATIC_REQUIRE( std::is_same_v< decltype(peaks)::value_type, fixed_image<g_f, 3, 3> > );
+    REQUIRE( peaks.size() == 3 );
+    for ( size_t i=0; i<peaks.size(); ++i )
+    {
+        CHECK( peaks[i].rect() == views[i].rect() );
+        for ( uint32_t h=0; h<3; ++h )
+            for ( uint32_t w=0; w<3; ++w )
+                CHECK( peaks[i][ {w, h} ] == views[i][ {w, h} ] );
+        CHECK( fit_simple_gaussian( peaks[i] ) == fit_simple_gaussian( views[i] ) );
+    }
+    CHECK( peaks[0].rect().midpoint() == rect::point_t( 60, 60 ) );
+    CHECK( peaks[0][ {1, 2} ] == 10.0 );
+
+    // larger neighbourhoods, fewer peaks than requested
+    auto wide{ find_fixed_peaks<2>( im, 10 ) };
+    REQUIRE( wide.size() == 5 );
+    CHECK( wide[0].size() == size( 5, 5 ) );
+    CHECK( wide[4].rect().midpoint() == rect::point_t( 30, 30 ) );
+
+    CHECK( find_fixed_peaks<1>( im, 0 ).empty() );
+    CHECK( find_fixed_peaks<1>( gf_image{ 100, 100 }, 3 ).empty() );
+    CHECK( find_fixed_peaks<1>( gf_image{ 2, 2 }, 3 ).empty() );
+}
+
+TEST_CASE("image_utils_test - tiled_transpose_test")
+{
+    // large enough to be split across threads, with partial tiles
+    gf_image im{ 1031, 517 };
+    fill( im, []( uint32_t x, uint32_t y ){ return x * 1000 + y; } );
+
+    const gf_image transposed{ transpose( im ) };
+    REQUIRE( transposed.size() == size{ 517, 1031 } );
+
+    bool result = true;
+    for ( uint32_t y=0; y<transposed.height(); ++y )
+        for ( uint32_t x=0; x<transposed.width(); ++x )
+            result &= transposed[ {x, y} ] == y * 1000 + x;
+    REQUIRE( result );
+}
+
+namespace {
+    /// brute force 2-D separable convolution with edges repeated
+    gf_image reference_convolution( const gf_image& im, const std::vector<double>& kx, const std::vector<double>& ky )
+    {
+        const int32_t rx = kx.size() / 2;
+        const int32_t ry = ky.size() / 2;
+        const int32_t w = im.width();
+        const int32_t h = im.height();
+        gf_image result{ im.size() };
+        for ( int32_t y=0; y<h; ++y )
+            for ( int32_t x=0; x<w; ++x )
+            {
+                double sum = 0;
+                for ( int32_t j=-ry; j<=ry; ++j )
+                    for ( int32_t i=-rx; i<=rx; ++i )
+                    {
+                        const uint32_t sx = std::clamp( x - i, 0, w - 1 );
+                        const uint32_t sy = std::clamp( y - j, 0, h - 1 );
+                        sum += kx[i + rx] * ky[j + ry] * im[ {sx, sy} ];
+                    }
+                result[ {static_cast<uint32_t>( x ), static_cast<uint32_t>( y )} ] = sum;
+            }
+
+        return result;
+    }
+
+    double max_difference( const gf_image& a, const gf_image& b )
+    {
+        double result = 0;
+        for ( uint32_t i=0; i<a.pixel_count(); ++i )
+            result = std::max<double>( result, std::abs( a[i] - b[i] ) );
+        return result;
+    }
+
+    gf_image make_pattern( const size& s )
+    {
+        gf_image result{ s };
+        fill( result, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17 + ( x * y ) % 5; } );
+        return result;
+    }
+}
+
+TEST_CASE("image_utils_test - convolve_separable_test")
+{
+    // odd sizes to exercise the scalar tails of the row kernels
+    const gf_image im{ make_pattern( { 37, 23 } ) };
+
+    // identity
+    CHECK( max_difference( convolve_separable( im, { 1 }, { 0, 1, 0 } ), im ) == 0 );
+
+    // asymmetric kernels are convolved, not correlated
+    const std::vector<double> kx{ 0.5, 0.25, 0.125, 0.0625, 0.0625 };
+    const std::vector<double> ky{ -1, 0, 2 };
+    CHECK( max_difference( convolve_separable( im, kx, ky ), reference_convolution( im, kx, ky ) ) < 1e-4 );
+
+    // Gaussian
+    const auto k = gaussian_kernel( 1.5 );
+    REQUIRE( k.size() == 11 );
+    CHECK( std::abs( std::accumulate( k.begin(), k.end(), 0.0 ) - 1 ) < 1e-12 );
+    CHECK( max_difference( gaussian_blur( im, 1.5 ), reference_convolution( im, k, k ) ) < 1e-4 );
+
+    // integer pixels are rounded and clamped
+    g8_image im8{ 20, 3, g_8{ 200 } };
+    im8[ {10, 1} ] = 0;
+    const g8_image doubled{ convolve_separable( im8, { 2 }, { 1 } ) };
+    CHECK( doubled[ {0, 0} ] == 255 );
+    CHECK( doubled[ {10, 1} ] == 0 );
+    const g8_image averaged{ convolve_separable( im8, { 1.0/3, 1.0/3, 1.0/3 }, { 1 } ) };
+    CHECK( averaged[ {10, 1} ] == 133 );
+
+    CHECK_THROWS_AS( convolve_separable( im, { 1, 1 }, { 1 } ), std::invalid_argument );
+    CHECK_THROWS_AS( gaussian_kernel( 0 ), std::invalid_argument );
+}
+
+TEST_CASE("image_utils_test - box_blur_test")
+{
+    const gf_image im{ make_pattern( { 37, 23 } ) };
+    for ( uint32_t radius : { 0, 1, 4 } )
+    {
+        const std::vector<double> k( 2 * radius + 1, 1.0 / ( 2 * radius + 1 ) );
+        CHECK( max_difference( box_blur( im, radius ), reference_convolution( im, k, k ) ) < 1e-4 );
+    }
+}
+
+TEST_CASE("image_utils_test - recursive_gaussian_blur_test")
+{
+    // a constant is preserved
+    const gf_image constant{ 40, 30, g_f{ 5 } };
+    CHECK( max_difference( recursive_gaussian_blur( constant, 4.0 ), constant ) < 1e-4 );
+
+    // an impulse gives approximately a Gaussian of unit mass; the
+    // recursive filter is within a few percent
+    for ( double sigma : { 2.0, 3.0, 8.0 } )
+    {
+        gf_image impulse{ 129, 129 };
+        impulse[ {64, 64} ] = 1;
+        const gf_image blurred{ recursive_gaussian_blur( impulse, sigma ) };
+        const gf_image expected{ gaussian_blur( impulse, sigma ) };
+
+        CHECK( std::abs( pixel_sum( blurred ) - 1 ) < 1e-3 );
+        CHECK( max_difference( blurred, expected ) < 0.1 * expected[ {64, 64} ] );
+    }
+
+    CHECK_THROWS_AS( recursive_gaussian_blur( constant, 0.25 ), std::invalid_argument );
+}
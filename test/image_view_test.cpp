@@ -4,6 +4,9 @@
 #include <catch2/matchers/catch_matchers_all.hpp>
 
 // std
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -249,6 +252,25 @@ TEST_CASE("image_view_test - out_of_bounds_test")
         ContainsSubstring( "not contained within image"s, CaseSensitive::No ) );
 }
 
+#ifndef NDEBUG
+TEST_CASE("image_view_test - const_index_out_of_bounds_test")
+{
+    g8_image im; g_8 v;
+    std::tie( im, v ) = create_and_fill( {200, 200}, 0_g8 );
+    const auto iv = create_image_view( im, { {50, 50}, {100, 100} } );
+
+    _REQUIRE_THROWS_MATCHES(
+        iv[ 100*100 ],
+        std::out_of_range,
+        ContainsSubstring( "index outside of allowed area"s ) );
+    const point2<uint32_t> outside{ 100, 0 };
+    _REQUIRE_THROWS_MATCHES(
+        iv[ outside ],
+        std::out_of_range,
+        ContainsSubstring( "point outside of allowed area"s ) );
+}
+#endif
+
 TEST_CASE("image_view_test - convertion_test")
 {
     g8_image im; g_8 v;
@@ -287,3 +309,55 @@ TEST_CASE("image_view_test - fill_test")
     REQUIRE( save_to_file( "view_fill_test.pgm", im ) );
 }
 
+
+TEST_CASE("image_view_test - rows_test")
+{
+    gf_image im{ size{ 20, 10 }, image_layout::aligned };
+    std::iota( std::begin( im ), std::end( im ), 0 );
+    const auto iv = create_image_view( im, { {3, 2}, {5, 4} } );
+
+    const auto rows = iv.rows();
+    REQUIRE( rows.size() == 4 );
+    uint32_t h = 0;
+    for ( auto row : rows )
+    {
+        REQUIRE( row.size() == 5 );
+        REQUIRE( row.data() == iv.line(h) );
+        REQUIRE( row[4] == ( 2 + h ) * 20 + 7 );
+        ++h;
+    }
+    REQUIRE( h == 4 );
+
+    // writes through rows of a non-const view
+    auto wv = create_image_view( im, { {0, 0}, {2, 2} } );
+    for ( auto row : wv.rows() )
+        for ( auto& p : row )
+            p = -1;
+    REQUIRE( im[ {1, 1} ] == -1 );
+    REQUIRE( im[ {2, 1} ] == 22 );
+
+    REQUIRE( pixel_sum( iv ) == pixel_sum( extract( im, iv.rect() ) ) );
+    REQUIRE( find_image_range( iv ) == std::make_tuple( g_f{ 43 }, g_f{ 107 } ) );
+}
+
+TEST_CASE("image_view_test - random_access_iterator_test")
+{
+    g16_image im{ 16, 16 };
+    std::iota( std::begin( im ), std::end( im ), 0 );
+    auto iv = create_image_view( im, { {4, 4}, {8, 8} } );
+
+    using category = std::iterator_traits<decltype( iv.begin() )>::iterator_category;
+    STATIC_REQUIRE( std::is_same_v<category, std::random_access_iterator_tag> );
+
+    auto b = iv.begin();
+    REQUIRE( std::distance( b, iv.end() ) == 64 );
+    REQUIRE( b[9] == iv[ {1, 1} ] );
+    REQUIRE( *( b + 63 ) == 11 * 16 + 11 );
+    REQUIRE( *( iv.end() - 1 ) == 11 * 16 + 11 );
+
+    // sorting a view only touches its pixels
+    std::sort( iv.begin(), iv.end(), []( auto a, auto b ){ return b < a; } );
+    REQUIRE( iv[ {0, 0} ] == 11 * 16 + 11 );
+    REQUIRE( im[ {3, 4} ] == 4 * 16 + 3 );
+    REQUIRE( im[ {12, 11} ] == 11 * 16 + 12 );
+}
@@ -0,0 +1,128 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cstdlib>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/direct_correlation.h"
+#include "algos/integer_correlation.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace std::string_literals;
+using namespace Catch;
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    template < typename T >
+    image<g<T>> make_window( const size& s, uint32_t offset, uint32_t scale )
+    {
+        image<g<T>> result{ s };
+        fill( result, [offset, scale]( uint32_t x, uint32_t y ){ return ((x + offset) * 7 + y * 13) % 17 * scale; } );
+        return result;
+    }
+}
+
+TEST_CASE("integer_correlation_test - 8-bit matches direct correlation")
+{
+    const size s{ 40, 24 };
+    const auto a = make_window<uint8_t>( s, 0, 15 );
+    const auto b = make_window<uint8_t>( s, 3, 15 );
+
+    IntegerCorrelation integer{ s, 4 };
+    DirectCorrelation direct{ s, 4 };
+
+    gf_image output{ integer.cross_correlate( a, b ) };
+    gf_image expected{ direct.cross_correlate( gf_image{ a }, gf_image{ b } ) };
+    REQUIRE( output.size() == s );
+
+    for ( uint32_t i=0; i<output.pixel_count(); ++i )
+        REQUIRE_THAT( (double)output[i], WithinAbs( expected[i], 1e-6 ) );
+}
+
+TEST_CASE("integer_correlation_test - 12-bit data in 16-bit image")
+{
+    const size s{ 32, 32 };
+    const auto a = make_window<uint16_t>( s, 0, 255 );
+    const auto b = make_window<uint16_t>( s, 5, 255 );
+
+    IntegerCorrelation integer{ s, 3, 12 };
+    REQUIRE( integer.shift<uint16_t>() == 0 );
+    DirectCorrelation direct{ s, 3 };
+
+    gf_image output{ integer.cross_correlate( create_image_view( a, a.rect() ), create_image_view( b, b.rect() ) ) };
+    gf_image expected{ direct.cross_correlate( gf_image{ a }, gf_image{ b } ) };
+
+    for ( uint32_t i=0; i<output.pixel_count(); ++i )
+        REQUIRE_THAT( (double)output[i], WithinAbs( expected[i], 1e-6 ) );
+}
+
+TEST_CASE("integer_correlation_test - 16-bit data is shifted")
+{
+    const size s{ 16, 16 };
+    const auto a = make_window<uint16_t>( s, 0, 4096 );
+
+    IntegerCorrelation integer{ s, 2, 16 };
+    REQUIRE( integer.shift<uint16_t>() == 4 );
+    DirectCorrelation direct{ s, 2 };
+
+    // values are multiples of 16 so no bits are lost
+    gf_image output{ integer.cross_correlate( a, a ) };
+    gf_image expected{ direct.cross_correlate( gf_image{ a }, gf_image{ a } ) };
+    const double v = output[ {8, 8} ];
+    REQUIRE_THAT( v, WithinRel( (double)expected[ {8, 8} ], 1e-12 ) );
+}
+
+TEST_CASE("integer_correlation_test - default bit depth is that of the pixel type")
+{
+    const size s{ 16, 16 };
+    IntegerCorrelation integer{ s, 2 };
+    REQUIRE( integer.shift<uint8_t>() == 0 );
+    REQUIRE( integer.shift<uint16_t>() == 4 );
+
+    // full range 16-bit data, with values that would wrap as int16_t;
+    // multiples of 16 so no bits are lost
+    g16_image b{ s };
+    fill( b, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 15 * 2048 + 32768; } );
+
+    DirectCorrelation direct{ s, 2 };
+    gf_image output{ integer.cross_correlate( b, b ) };
+    gf_image expected{ direct.cross_correlate( gf_image{ b }, gf_image{ b } ) };
+    const double v = output[ {8, 8} ];
+    REQUIRE_THAT( v, WithinRel( (double)expected[ {8, 8} ], 1e-12 ) );
+}
+
+TEST_CASE("integer_correlation_test - pixels exceeding bit depth")
+{
+    const size s{ 16, 16 };
+    IntegerCorrelation integer{ s, 2, 12 };
+    const auto a = make_window<uint16_t>( s, 0, 255 );
+    g16_image b{ a };
+    b[ {3, 3} ] = 4096;
+
+    REQUIRE_NOTHROW( integer.cross_correlate( a, a ) );
+    _REQUIRE_THROWS_MATCHES( integer.cross_correlate( a, b ),
+                             std::runtime_error,
+                             ContainsSubstring( "exceed bit depth"s ) );
+}
+
+TEST_CASE("integer_correlation_test - invalid parameters")
+{
+    _REQUIRE_THROWS_MATCHES( IntegerCorrelation( size{ 0, 0 }, 4 ),
+                             std::runtime_error,
+                             ContainsSubstring( "non-zero"s, CaseSensitive::No ) );
+    _REQUIRE_THROWS_MATCHES( IntegerCorrelation( size{ 1024, 16 }, 4 ),
+                             std::runtime_error,
+                             ContainsSubstring( "width"s, CaseSensitive::No ) );
+    _REQUIRE_THROWS_MATCHES( IntegerCorrelation( size{ 16, 16 }, 4, 17 ),
+                             std::runtime_error,
+                             ContainsSubstring( "bit depth"s, CaseSensitive::No ) );
+}
@@ -3,6 +3,8 @@
 #include <catch2/catch_test_macros.hpp>
 
 // std
+#include <cmath>
+#include <limits>
 #include <utility>
 
 // to be tested
@@ -86,9 +88,79 @@ TEST_CASE("pixel_types_test - pixel_conversion_test")
         REQUIRE( (pixeltype_is_convertible_v< g_8, g_32 >) );
         REQUIRE( (pixeltype_is_convertible_v< g_8, g_f >) );
         REQUIRE( (pixeltype_is_convertible_v< g_f, c_f >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_16, g_h >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_h, g_f >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_f, g_h >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_h, c_f >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_bf, g_f >) );
+        REQUIRE( (pixeltype_is_convertible_v< g_f, g_bf >) );
+        REQUIRE( (pixeltype_is_convertible_v< rgba_16, g_h >) );
     }
 }
 
+TEST_CASE("pixel_types_test - half_test")
+{
+    REQUIRE( sizeof(g_h) == 2 );
+    REQUIRE( std::is_same_v< arithmetic_t<half>, float > );
+
+    // every value that isn't a NaN survives a round trip through float
+    bool result = true;
+    for ( uint32_t bits=0; bits<0x10000; ++bits )
+    {
+        const half h = half::from_bits( bits );
+        const float f = h;
+        if ( std::isnan( f ) )
+            result &= ( bits & 0x7c00 ) == 0x7c00 && ( bits & 0x3ff ) != 0;
+        else
+            result &= half( f ).bits == bits;
+    }
+    REQUIRE( result );
+
+    // rounding: ties to even, overflow to infinity, subnormals
+    CHECK( half( 2049.0f ).bits == half( 2048.0f ).bits );
+    CHECK( half( 2051.0f ).bits == half( 2052.0f ).bits );
+    CHECK( half( 65520.0f ).bits == std::numeric_limits<half>::infinity().bits );
+    CHECK( half( -1e6f ).bits == 0xfc00 );
+    CHECK( static_cast<float>( half( 5.96046448e-8f ) ) == std::ldexp( 1.0f, -24 ) );
+    CHECK( static_cast<float>( std::numeric_limits<half>::max() ) == 65504.0f );
+    CHECK( static_cast<float>( std::numeric_limits<half>::epsilon() ) == std::ldexp( 1.0f, -10 ) );
+
+    // greyscale arithmetic is in float
+    g_h a = 1.5;
+    g_f b = a;
+    g_h c = b * 2;
+    CHECK( b == 1.5 );
+    CHECK( c == 3 );
+    CHECK( a < c );
+    CHECK( g_h{ g_16{ 1000 } } == 1000 );
+    CHECK( g_16{ g_h{ 1000.0 } } == 1000 );
+}
+
+TEST_CASE("pixel_types_test - bfloat16_test")
+{
+    REQUIRE( sizeof(g_bf) == 2 );
+    REQUIRE( std::is_same_v< arithmetic_t<bfloat16>, float > );
+
+    bool result = true;
+    for ( uint32_t bits=0; bits<0x10000; ++bits )
+    {
+        const float f = bfloat16::from_bits( bits );
+        if ( !std::isnan( f ) )
+            result &= bfloat16( f ).bits == bits;
+    }
+    REQUIRE( result );
+
+    CHECK( bfloat16( 257.0f ).bits == bfloat16( 256.0f ).bits );
+    CHECK( bfloat16( 259.0f ).bits == bfloat16( 260.0f ).bits );
+    CHECK( std::isnan( static_cast<float>( bfloat16( std::numeric_limits<float>::quiet_NaN() ) ) ) );
+    CHECK( static_cast<float>( std::numeric_limits<bfloat16>::max() ) == 3.38953139e38f );
+
+    g_bf a = 1.5;
+    g_f b = a;
+    CHECK( b == 1.5 );
+    CHECK( g_bf{ g_16{ 1000 } } == 1000 );
+}
+
 TEST_CASE("pixel_types_test - rgba_Test")
 {
     REQUIRE( rgba_8( 0, 0, 0, 0 ) == rgba_8() );
@@ -80,6 +80,19 @@ TEST_CASE("rect_test - contains_test")
     REQUIRE_FALSE( r.contains( rect( {6, 6}, {10, 8})) );
 }
 
+TEST_CASE("rect_test - intersects_test")
+{
+    rect r({5, 5}, {10, 10});
+    REQUIRE( r.intersects( rect( {5, 5}, {10, 10})) );
+    REQUIRE( r.intersects( rect( {0, 0}, {6, 6})) );
+    REQUIRE( r.intersects( rect( {14, 14}, {8, 8})) );
+    REQUIRE( r.intersects( rect( {0, 0}, {20, 20})) );
+    REQUIRE_FALSE( r.intersects( rect( {0, 0}, {5, 5})) );
+    REQUIRE_FALSE( r.intersects( rect( {15, 5}, {10, 10})) );
+    REQUIRE_FALSE( r.intersects( rect( {5, 15}, {10, 10})) );
+    REQUIRE_FALSE( r.intersects( rect( {-10, 5}, {10, 10})) );
+}
+
 TEST_CASE("rect_test - midpoint_test")
 {
     rect r({5, 5}, {10, 10});
@@ -0,0 +1,108 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/fft.h"
+#include "algos/sliding_dft.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+#include "core/image_view.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    gf_image make_image( const size& s )
+    {
+        gf_image result{ s };
+        fill( result, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13 + (x * y) % 5) % 17; } );
+        return result;
+    }
+
+    void require_equal( const cf_image& actual, const cf_image& expected )
+    {
+        REQUIRE( actual.size() == expected.size() );
+        for ( uint32_t i=0; i<actual.pixel_count(); ++i )
+        {
+            REQUIRE_THAT( actual[i].real, WithinAbs( expected[i].real, 1e-6 ) );
+            REQUIRE_THAT( actual[i].imag, WithinAbs( expected[i].imag, 1e-6 ) );
+        }
+    }
+}
+
+TEST_CASE("sliding_dft_test - transform_columns")
+{
+    const gf_image im{ make_image( {24, 8} ) };
+    FFT fft( {8, 8} );
+
+    cf_image columns;
+    fft.transform_columns( im, columns );
+    REQUIRE( columns.size() == size{ 8, 24 } );
+
+    // a window's columns transformed along x gives its 2-D transform
+    cf_image spectrum;
+    fft.transform_columns( create_image_view( columns, rect{ {0, 4}, {8, 8} } ), spectrum );
+    require_equal( spectrum, fft.transform( create_image_view( im, rect{ {4, 0}, {8, 8} } ) ) );
+}
+
+TEST_CASE("sliding_dft_test - matches full transform")
+{
+    const gf_image im{ make_image( {96, 48} ) };
+    const size s{ 16, 8 };
+    FFT fft( s );
+
+    for ( uint32_t step : { 1, 2, 3, 4, 9 } )
+    {
+        SlidingDFT sliding( s, 4 );
+        rect window{ {5, 7}, s };
+        require_equal( sliding.start( im, window ), fft.transform( create_image_view( im, window ) ) );
+
+        while ( window.right() + step <= im.width() )
+        {
+            window = rect{ { window.left() + static_cast<int32_t>(step), window.bottom() }, s };
+            require_equal( sliding.advance( step ), fft.transform( create_image_view( im, window ) ) );
+            REQUIRE( sliding.window() == window );
+        }
+    }
+}
+
+TEST_CASE("sliding_dft_test - large steps")
+{
+    // steps of 32 or more are 50% overlap for 64 pixel windows
+    const gf_image im{ make_image( {256, 64} ) };
+    const size s{ 64, 64 };
+    FFT fft( s );
+
+    for ( uint32_t step : { 32, 40, 63 } )
+    {
+        SlidingDFT sliding( s );
+        rect window{ {0, 0}, s };
+        sliding.start( im, window );
+
+        while ( window.right() + step <= im.width() )
+        {
+            window = rect{ { window.left() + static_cast<int32_t>(step), window.bottom() }, s };
+            require_equal( sliding.advance( step ), fft.transform( create_image_view( im, window ) ) );
+        }
+    }
+}
+
+TEST_CASE("sliding_dft_test - errors")
+{
+    const gf_image im{ make_image( {32, 16} ) };
+    SlidingDFT sliding( {8, 8} );
+
+    REQUIRE_THROWS( SlidingDFT( {8, 8}, 0 ) );
+    REQUIRE_THROWS( sliding.start( im, rect{ {0, 0}, {16, 8} } ) );
+    REQUIRE_THROWS( sliding.start( im, rect{ {0, 12}, {8, 8} } ) );
+
+    sliding.start( im, rect{ {20, 0}, {8, 8} } );
+    REQUIRE_NOTHROW( sliding.advance( 4 ) );
+    REQUIRE_THROWS( sliding.advance( 1 ) );
+}
@@ -0,0 +1,131 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/ensemble_correlation.h"
+#include "algos/fft.h"
+#include "algos/spectrum_cache.h"
+#include "core/grid.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    gf_image make_frame( const size& s, uint32_t offset )
+    {
+        gf_image result{ s };
+        fill( result, [offset]( uint32_t x, uint32_t y ){ return ((x + offset) * 7 + y * 13) % 17; } );
+        return result;
+    }
+}
+
+TEST_CASE("spectrum_cache_test - find & insert")
+{
+    const rect window{ {0, 0}, {8, 8} };
+    const size_t bytes = window.area() * sizeof(c_f);
+    spectrum_cache cache{ 2 * bytes };
+
+    REQUIRE( !cache.find( { 1, window } ) );
+    cache.insert( { 1, window }, cf_image{ window.size(), c_f{ 1, 0 } } );
+    cache.insert( { 2, window }, cf_image{ window.size(), c_f{ 2, 0 } } );
+    REQUIRE( cache.size() == 2 );
+    REQUIRE( cache.memory() == 2 * bytes );
+
+    auto s = cache.find( { 1, window } );
+    REQUIRE( s );
+    REQUIRE( (*s)[0] == c_f{ 1, 0 } );
+    REQUIRE( cache.hits() == 1 );
+    REQUIRE( cache.misses() == 1 );
+
+    // settings are part of the key
+    REQUIRE( !cache.find( { 1, window, 7 } ) );
+}
+
+TEST_CASE("spectrum_cache_test - least recently used are evicted")
+{
+    const rect window{ {0, 0}, {8, 8} };
+    const size_t bytes = window.area() * sizeof(c_f);
+    spectrum_cache cache{ 2 * bytes };
+
+    auto held = cache.insert( { 1, window }, cf_image{ window.size(), c_f{ 1, 0 } } );
+    cache.insert( { 2, window }, cf_image{ window.size() } );
+    cache.find( { 1, window } );
+    cache.insert( { 3, window }, cf_image{ window.size() } );
+
+    REQUIRE( cache.size() == 2 );
+    REQUIRE( cache.memory() <= cache.capacity() );
+    REQUIRE( cache.find( { 1, window } ) );
+    REQUIRE( !cache.find( { 2, window } ) );
+    REQUIRE( cache.find( { 3, window } ) );
+
+    // evicted entries remain valid while held
+    cache.clear();
+    REQUIRE( cache.size() == 0 );
+    REQUIRE( (*held)[0] == c_f{ 1, 0 } );
+}
+
+TEST_CASE("spectrum_cache_test - get computes once")
+{
+    const rect window{ {0, 0}, {8, 8} };
+    spectrum_cache cache{ 1 << 20 };
+
+    size_t computed = 0;
+    auto compute = [&computed, &window](){ ++computed; return cf_image{ window.size() }; };
+    auto a = cache.get( { 1, window }, compute );
+    auto b = cache.get( { 1, window }, compute );
+    REQUIRE( computed == 1 );
+    REQUIRE( a == b );
+}
+
+TEST_CASE("spectrum_cache_test - cross_correlate_spectra")
+{
+    const size s{ 16, 16 };
+    const auto a = make_frame( s, 0 );
+    const auto b = make_frame( s, 3 );
+    FFT fft{ s };
+
+    const cf_image a_fft{ fft.transform( a ) };
+    const cf_image b_fft{ fft.transform( b ) };
+    const gf_image expected{ fft.cross_correlate( a, b ) };
+    const gf_image output{ fft.cross_correlate_spectra( a_fft, b_fft ) };
+    for ( uint32_t i=0; i<output.pixel_count(); ++i )
+        REQUIRE_THAT( (double)output[i], WithinAbs( expected[i], 1e-6 ) );
+}
+
+TEST_CASE("spectrum_cache_test - time-resolved ensemble")
+{
+    const size s{ 64, 64 };
+    const auto grid = generate_cartesian_grid( s, { 32, 32 }, 0.5 );
+    std::vector<gf_image> frames;
+    for ( uint32_t i=0; i<4; ++i )
+        frames.push_back( make_frame( s, i ) );
+
+    EnsembleCorrelation<> expected{ grid };
+    EnsembleCorrelation<> cached{ grid };
+    spectrum_cache cache{ 1 << 20 };
+    for ( uint32_t i=0; i+1<frames.size(); ++i )
+    {
+        expected.add( frames[i], frames[i + 1] );
+        cached.add( frames[i], i, frames[i + 1], i + 1, cache );
+    }
+
+    // A-B, B-C, C-D: all but the first frame's spectra are reused once
+    REQUIRE( cache.hits() == 2 * grid.size() );
+    REQUIRE( cache.misses() == 4 * grid.size() );
+
+    for ( size_t i=0; i<grid.size(); ++i )
+    {
+        const gf_image e{ expected.correlation( i ) };
+        const gf_image o{ cached.correlation( i ) };
+        for ( uint32_t j=0; j<o.pixel_count(); ++j )
+            REQUIRE_THAT( (double)o[j], WithinAbs( e[j], 1e-9 ) );
+    }
+}
@@ -0,0 +1,122 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cmath>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/fft.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+#include "core/split_complex_image.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+namespace {
+    /// odd width to exercise the scalar tails of the kernels
+    cf_image make_spectrum( const size& s, uint32_t offset )
+    {
+        cf_image result{ s };
+        fill( result, [offset]( uint32_t x, uint32_t y ){
+            return c_f( ( ( x + offset ) * 7 + y * 13 ) % 17 - 8.0, ( x * 5 + ( y + offset ) * 3 ) % 11 - 5.0 ); } );
+        return result;
+    }
+
+    bool close( double a, double b )
+    {
+        return std::abs( a - b ) <= 1e-12 * std::max( 1.0, std::abs( b ) );
+    }
+}
+
+TEST_CASE("split_complex_image_test - interleave round trip")
+{
+    const cf_image im{ make_spectrum( { 19, 7 }, 0 ) };
+    split_cf_image split{ im };
+
+    REQUIRE( split.size() == im.size() );
+    CHECK( split[ {3, 4} ] == im[ {3, 4} ] );
+    CHECK( split.real()[ {18, 6} ] == im[ {18, 6} ].real );
+    CHECK( split.imag()[ {18, 6} ] == im[ {18, 6} ].imag );
+    CHECK( split.interleaved() == im );
+
+    split.set( {0, 0}, c_f( 1, 2 ) );
+    CHECK( split[ {0, 0} ] == c_f( 1, 2 ) );
+}
+
+TEST_CASE("split_complex_image_test - conj_multiply")
+{
+    const cf_image a{ make_spectrum( { 19, 7 }, 0 ) };
+    const cf_image b{ make_spectrum( { 19, 7 }, 3 ) };
+    const cf_image expected{ b * conj( a ) };
+
+    split_cf_image split_product;
+    conj_multiply( split_cf_image{ a }, split_cf_image{ b }, split_product );
+    cf_image product;
+    conj_multiply( split_cf_image{ a }, split_cf_image{ b }, product );
+
+    bool result = true;
+    for ( uint32_t y = 0; y < a.height(); ++y )
+        for ( uint32_t x = 0; x < a.width(); ++x )
+        {
+            const c_f e = expected[ {x, y} ];
+            result &= close( split_product[ {x, y} ].real, e.real ) && close( split_product[ {x, y} ].imag, e.imag );
+            result &= close( product[ {x, y} ].real, e.real ) && close( product[ {x, y} ].imag, e.imag );
+        }
+    CHECK( result );
+
+    _REQUIRE_THROWS_MATCHES( conj_multiply( split_cf_image{ a }, split_cf_image{ 4, 4 }, product ),
+                             std::runtime_error, ContainsSubstring( "image sizes are different" ) );
+}
+
+TEST_CASE("split_complex_image_test - magnitude & normalize")
+{
+    const cf_image im{ make_spectrum( { 19, 7 }, 1 ) };
+    split_cf_image split{ im };
+    split.set( {5, 5}, c_f{} );
+
+    const gf_image mag_sqr{ abs_sqr( split ) };
+    const gf_image mag{ abs( split ) };
+    normalize( split );
+
+    bool result = true;
+    for ( uint32_t y = 0; y < im.height(); ++y )
+        for ( uint32_t x = 0; x < im.width(); ++x )
+        {
+            const c_f v = ( x == 5 && y == 5 ) ? c_f{} : im[ {x, y} ];
+            result &= close( mag_sqr[ {x, y} ], v.abs_sqr() );
+            result &= close( mag[ {x, y} ], v.abs() );
+            if ( v.abs() > 0 )
+                result &= close( split[ {x, y} ].real, v.real / v.abs() ) && close( split[ {x, y} ].imag, v.imag / v.abs() );
+            else
+                result &= split[ {x, y} ] == c_f{};
+        }
+    CHECK( result );
+}
+
+TEST_CASE("split_complex_image_test - cross_correlate_spectra")
+{
+    size s{ 32, 32 };
+    gf_image a{ s };
+    gf_image b{ s };
+    fill( a, []( uint32_t x, uint32_t y ){ return ( x * 7 + y * 13 ) % 17; } );
+    fill( b, []( uint32_t x, uint32_t y ){ return ( ( x + 2 ) * 7 + ( y + 1 ) * 13 ) % 17; } );
+
+    FFT fft( s );
+    const gf_image expected{ fft.cross_correlate( a, b ) };
+    const split_cf_image a_fft{ fft.transform_split( a ) };
+    const split_cf_image b_fft{ fft.transform_split( b ) };
+    const gf_image output{ fft.cross_correlate_spectra( a_fft, b_fft ) };
+
+    bool result = true;
+    for ( uint32_t y = 0; y < s.height(); ++y )
+        for ( uint32_t x = 0; x < s.width(); ++x )
+            result &= std::abs( output[ {x, y} ] - expected[ {x, y} ] ) < 1e-6;
+    CHECK( result );
+}
@@ -0,0 +1,97 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cstdint>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "core/image.h"
+#include "core/image_utils.h"
+#include "core/summed_area_table.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+
+namespace {
+    template < typename ImageT >
+    double direct_sum( const ImageT& im, const rect& r, bool squared = false )
+    {
+        double result = 0;
+        for ( uint32_t y=r.bottom(); y<(uint32_t)r.top(); ++y )
+            for ( uint32_t x=r.left(); x<(uint32_t)r.right(); ++x )
+            {
+                const double v = im[ {x, y} ];
+                result += squared ? v*v : v;
+            }
+
+        return result;
+    }
+}
+
+TEST_CASE("summed_area_table_test - accumulator types")
+{
+    STATIC_REQUIRE( std::is_same_v< sat_accumulator_t<g_8>, int64_t > );
+    STATIC_REQUIRE( std::is_same_v< sat_accumulator_t<g_16>, int64_t > );
+    STATIC_REQUIRE( std::is_same_v< sat_accumulator_t<g_f>, double > );
+    STATIC_REQUIRE( std::is_same_v< sat_squared_accumulator_t<g_16>, int64_t > );
+    STATIC_REQUIRE( std::is_same_v< sat_squared_accumulator_t<g_32>, double > );
+}
+
+TEST_CASE("summed_area_table_test - matches direct sum")
+{
+    // odd width to exercise the scalar tail of the prefix scan
+    g16_image im{ 37, 23 };
+    fill( im, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13) % 50; } );
+
+    auto sat = make_summed_area_table( im );
+    auto sat_sqr = make_squared_summed_area_table( im );
+    REQUIRE( sat.size() == im.size() );
+    REQUIRE( sat.at( 0, 0 ) == 0 );
+
+    for ( const auto& r : { rect::from_size( im.size() ),
+                            rect{ {0, 0}, {1, 1} },
+                            rect{ {3, 5}, {17, 9} },
+                            rect{ {36, 22}, {1, 1} },
+                            rect{ {10, 10}, {0, 5} } } )
+    {
+        REQUIRE( sat.sum( r ) == direct_sum( im, r ) );
+        REQUIRE( sat_sqr.sum( r ) == direct_sum( im, r, true ) );
+    }
+}
+
+TEST_CASE("summed_area_table_test - no overflow on 16-bit frames")
+{
+    // large enough to use multiple blocks
+    g16_image im{ 1024, 1024, 65535 };
+
+    auto sat = make_summed_area_table( im );
+    auto sat_sqr = make_squared_summed_area_table( im );
+    const auto r = rect::from_size( im.size() );
+    REQUIRE( sat.sum( r ) == int64_t{65535} * 1024 * 1024 );
+    REQUIRE( sat_sqr.sum( r ) == int64_t{65535} * 65535 * 1024 * 1024 );
+    REQUIRE( sat.sum( rect{ {100, 200}, {300, 400} } ) == int64_t{65535} * 300 * 400 );
+}
+
+TEST_CASE("summed_area_table_test - mean and variance")
+{
+    gf_image im{ 64, 64 };
+    fill( im, []( uint32_t x, uint32_t ){ return x % 2 ? 3.0 : 1.0; } );
+
+    auto sat = make_summed_area_table( im );
+    auto sat_sqr = make_squared_summed_area_table( im );
+    const rect r{ {4, 4}, {16, 16} };
+    REQUIRE_THAT( sat.mean( r ), WithinAbs( 2.0, 1e-12 ) );
+    REQUIRE_THAT( variance( sat, sat_sqr, r ), WithinAbs( 1.0, 1e-9 ) );
+}
+
+TEST_CASE("summed_area_table_test - window outside image")
+{
+    g8_image im{ 32, 32 };
+    auto sat = make_summed_area_table( im );
+    REQUIRE_THROWS_AS( sat.sum( rect{ {16, 16}, {32, 32} } ), std::out_of_range );
+}
@@ -0,0 +1,83 @@
+
+// catch
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+// std
+#include <cmath>
+
+// local
+#include "test_utils.h"
+
+// to be tested
+#include "algos/window_stats.h"
+#include "core/image.h"
+#include "core/image_utils.h"
+
+using namespace Catch::Matchers;
+using namespace openpiv::core;
+using namespace openpiv::algos;
+
+TEST_CASE("window_stats_test - constant image")
+{
+    gf_image im{ 64, 32, 10.0 };
+    window_statistics stats{ im };
+
+    auto s = stats( rect{ {5, 5}, {16, 16} } );
+    REQUIRE_THAT( s.mean, WithinAbs( 10.0, 1e-9 ) );
+    REQUIRE_THAT( s.stddev, WithinAbs( 0.0, 1e-6 ) );
+    REQUIRE( s.particles == 0 );
+}
+
+TEST_CASE("window_stats_test - matches direct calculation")
+{
+    g16_image im{ 64, 64 };
+    fill( im, []( uint32_t x, uint32_t y ){ return (x * 7 + y * 13) % 50; } );
+    window_statistics stats{ im };
+
+    const rect r{ {10, 20}, {32, 16} };
+    double sum = 0, sum_sqr = 0;
+    for ( uint32_t y=r.bottom(); y<(uint32_t)r.top(); ++y )
+        for ( uint32_t x=r.left(); x<(uint32_t)r.right(); ++x )
+        {
+            const double v = im[ {x, y} ];
+            sum += v;
+            sum_sqr += v*v;
+        }
+    const double mean = sum / r.area();
+    const double stddev = std::sqrt( sum_sqr / r.area() - mean*mean );
+
+    auto s = stats( r );
+    REQUIRE_THAT( s.mean, WithinAbs( mean, 1e-9 ) );
+    REQUIRE_THAT( s.stddev, WithinAbs( stddev, 1e-6 ) );
+}
+
+TEST_CASE("window_stats_test - particle count")
+{
+    gf_image im{ 64, 64 };
+
+    // three isolated particles in the left half, one in the right
+    for ( const auto& p : { point2<uint32_t>{ 5, 5 }, point2<uint32_t>{ 10, 20 },
+                            point2<uint32_t>{ 20, 40 }, point2<uint32_t>{ 50, 50 } } )
+        im[ p ] = 100;
+
+    window_statistics stats{ im, 50.0 };
+    REQUIRE( stats( rect{ {0, 0}, {32, 64} } ).particles == 3 );
+    REQUIRE( stats( rect{ {32, 0}, {32, 64} } ).particles == 1 );
+    REQUIRE( stats( rect::from_size( im.size() ) ).particles == 4 );
+
+    // thresholds
+    signal_thresholds t;
+    REQUIRE_FALSE( t.enabled() );
+    t.minimum_particles = 2;
+    REQUIRE( t.enabled() );
+    REQUIRE_FALSE( is_low_signal( stats( rect{ {0, 0}, {32, 64} } ), t ) );
+    REQUIRE( is_low_signal( stats( rect{ {32, 0}, {32, 64} } ), t ) );
+}
+
+TEST_CASE("window_stats_test - window outside frame")
+{
+    gf_image im{ 32, 32 };
+    window_statistics stats{ im };
+    REQUIRE_THROWS_AS( stats( rect{ {16, 16}, {32, 32} } ), std::out_of_range );
+}